@@ -7,89 +7,753 @@
 
 #include <vector>
 #include <list>
+#include <map>
 #include <set>
 #include <functional>
 #include <iostream>
 #include <numeric>
 #include <memory>
 #include <optional>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <cmath>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "flat_hash_map.h"
+#include "hash_join.h"
+#include "window.h"
+#include "statistics.h"
+#include "sketches.h"
+#include "generator.h"
+#include "queues.h"
+#include "mapped_file.h"
+#include "csv.h"
+#include "json.h"
+#include "output.h"
 
 template <class> struct Trait;
 
 template<class T>
 struct Trait<std::list<T>> {
+    static constexpr bool sortedUnique = false;
+    static constexpr bool contiguous = false;
     static constexpr void (std::list<T>::*append)(const T&) = &std::list<T>::push_back;
+
+    static bool erase(std::list<T> &cont, const T &value) {
+        auto it = std::find(cont.begin(), cont.end(), value);
+        if (it == cont.end())
+            return false;
+        cont.erase(it);
+        return true;
+    }
 };
 
 template<class T>
 struct Trait<std::vector<T>> {
+    static constexpr bool sortedUnique = false;
+    static constexpr bool contiguous = true;
     static constexpr void (std::vector<T>::*append)(const T&) = &std::vector<T>::push_back;
+
+    static bool erase(std::vector<T> &cont, const T &value) {
+        auto it = std::find(cont.begin(), cont.end(), value);
+        if (it == cont.end())
+            return false;
+        cont.erase(it);
+        return true;
+    }
 };
 
 template<class T>
 struct Trait<std::set<T>> {
+    static constexpr bool sortedUnique = true;
+    static constexpr bool contiguous = false;
     static constexpr std::pair<typename std::set<T>::iterator,bool> (std::set<T>::*append)(const T&) = &std::set<T>::insert;
+
+    static bool erase(std::set<T> &cont, const T &value) {
+        return cont.erase(value) != 0;
+    }
 };
 
+// Downstream aggregations for groupingBy. A collector builds an initial
+// accumulator for a given element type, folds elements into it and turns it
+// into the final result.
+namespace Collectors {
+    struct Counting {
+        template<typename T>
+        size_t init() const { return 0; }
+
+        template<typename T>
+        void accumulate(size_t &n, const T &) const { n++; }
+
+        size_t finish(size_t n) const { return n; }
+    };
+
+    template<typename F>
+    struct Summing {
+        F func;
+
+        template<typename T>
+        std::decay_t<std::invoke_result_t<F, const T &>> init() const { return {}; }
+
+        template<typename A, typename T>
+        void accumulate(A &sum, const T &e) const { sum += func(e); }
+
+        template<typename A>
+        A finish(A sum) const { return sum; }
+    };
+
+    // The average of no elements is 0, e.g. for a side of partitioningBy
+    // which nothing matched.
+    template<typename F>
+    struct Averaging {
+        F func;
+
+        template<typename T>
+        std::pair<double, size_t> init() const { return {0.0, 0}; }
+
+        template<typename T>
+        void accumulate(std::pair<double, size_t> &acc, const T &e) const {
+            acc.first += func(e);
+            acc.second++;
+        }
+
+        double finish(const std::pair<double, size_t> &acc) const {
+            return acc.second ? acc.first / acc.second : 0.0;
+        }
+    };
+
+    struct ToVector {
+        template<typename T>
+        std::vector<T> init() const { return {}; }
+
+        template<typename T>
+        void accumulate(std::vector<T> &elements, const T &e) const { elements.push_back(e); }
+
+        template<typename T>
+        std::vector<T> finish(std::vector<T> elements) const { return elements; }
+    };
+
+    inline Counting counting() { return {}; }
+
+    template<typename F>
+    Summing<F> summing(F func) { return {func}; }
+
+    template<typename F>
+    Averaging<F> averaging(F func) { return {func}; }
+
+    inline ToVector toVector() { return {}; }
+}
+
 template<typename T, template <class...> typename Container>
 class Stream {
     template <typename Y, template <typename...> class Z>
     friend class Stream;
 
-    explicit Stream () : internalContainer(std::make_unique<Container<T>>()), originalContainerReference(*internalContainer) {}
+    // Returns the next element, or nullptr once the stream is exhausted. The
+    // element stays valid until the following call.
+    using Cursor = std::function<const T *()>;
+
+    explicit Stream (std::function<Cursor()> openCursor) : openCursor(std::move(openCursor)) {}
 public:
-    explicit Stream (const Container<T> & original) : originalContainerReference(original) {}
+    explicit Stream (const Container<T> & original) : originalContainer(&original), openCursor([&original]() -> Cursor {
+        return [it = original.begin(), end = original.end()]() mutable -> const T * {
+            return it == end ? nullptr : &*it++;
+        };
+    }), isSorted(Trait<Container<T>>::sortedUnique), isUnique(Trait<Container<T>>::sortedUnique) {}
+
+    template<typename F>
+    auto map(F func) -> Stream<std::decay_t<std::invoke_result_t<F, const T &>>, Container> {
+        using X = std::decay_t<std::invoke_result_t<F, const T &>>;
+        return Stream<X, Container>([up = openCursor, func]() -> typename Stream<X, Container>::Cursor {
+            return [cursor = up(), func, current = std::optional<X>()]() mutable -> const X * {
+                const T *e = cursor();
+                if (!e)
+                    return nullptr;
+                current.emplace(func(*e));
+                return &*current;
+            };
+        });
+    }
 
+    // func returns either a range, a Stream or (in C++20) a Generator per
+    // element, whose elements are pulled one by one by the downstream stages:
+    // nothing is concatenated.
     template<typename F>
-    auto map(F func) -> Stream<decltype(func(T())), Container> {
-        using X = decltype(func(T()));
-        Stream<X, Container> s;
-        for (const auto &e : originalContainerReference) {
-            auto &cont = *s.internalContainer;
-            (cont.*Trait<Container<X>>::append)(func(e));
+    auto flatMap(F func) {
+        using R = std::decay_t<std::invoke_result_t<F, const T &>>;
+        if constexpr (IsStream<R>::value) {
+            using X = typename IsStream<R>::value_type;
+            using InnerCursor = typename R::Cursor;
+            return Stream<X, Container>([up = openCursor, func]() -> typename Stream<X, Container>::Cursor {
+                return [cursor = up(), func, inner = std::optional<R>(), innerCursor = InnerCursor()]() mutable -> const X * {
+                    for (;;) {
+                        if (innerCursor) {
+                            if (const X *x = innerCursor())
+                                return x;
+                        }
+                        const T *e = cursor();
+                        if (!e)
+                            return nullptr;
+                        inner.emplace(func(*e));
+                        innerCursor = inner->openCursor();
+                    }
+                };
+            });
+        }
+#ifdef CPPSTREAMS_HAS_COROUTINES
+        else if constexpr (IsGenerator<R>::value) {
+            // Resumed through next(): its iterator can't be advanced before
+            // the yielded value is used. Shared to keep the cursor copyable.
+            using X = typename IsGenerator<R>::value_type;
+            return Stream<X, Container>([up = openCursor, func]() -> typename Stream<X, Container>::Cursor {
+                return [cursor = up(), func, inner = std::shared_ptr<R>()]() mutable -> const X * {
+                    for (;;) {
+                        if (inner) {
+                            if (const X *x = inner->next())
+                                return x;
+                        }
+                        const T *e = cursor();
+                        if (!e)
+                            return nullptr;
+                        inner = std::make_shared<R>(func(*e));
+                    }
+                };
+            });
+        }
+#endif
+        else {
+            using X = std::decay_t<decltype(*std::begin(std::declval<R &>()))>;
+            using Iterator = decltype(std::begin(std::declval<R &>()));
+            return Stream<X, Container>([up = openCursor, func]() -> typename Stream<X, Container>::Cursor {
+                return [cursor = up(), func, range = std::optional<R>(), it = Iterator(), end = Iterator()]() mutable -> const X * {
+                    while (!range || it == end) {
+                        const T *e = cursor();
+                        if (!e)
+                            return nullptr;
+                        range.emplace(func(*e));
+                        it = std::begin(*range);
+                        end = std::end(*range);
+                    }
+                    return &*it++;
+                };
+            });
         }
-        return s;
     }
 
     Stream<T, Container> filter(std::function<bool(const T &)> func) {
-        Stream<T, Container> s;
-        for (const auto &e : originalContainerReference) {
-            auto &cont = *s.internalContainer;
-            if (func(e))
-                (cont.*Trait<Container<T>>::append)(e);
+        return keepingOrder([up = openCursor, func]() -> Cursor {
+            return [cursor = up(), func]() mutable -> const T * {
+                while (const T *e = cursor()) {
+                    if (func(*e))
+                        return e;
+                }
+                return nullptr;
+            };
+        });
+    }
+
+    // A no-op over std::set sources, an adjacent comparison once sorted,
+    // and a FlatHashSet of the elements seen so far otherwise.
+    Stream<T, Container> distinct() {
+        if (isUnique)
+            return *this;
+        Stream<T, Container> s(isSorted ? std::function<Cursor()>([up = openCursor]() -> Cursor {
+            return [cursor = up(), last = std::optional<T>()]() mutable -> const T * {
+                while (const T *e = cursor()) {
+                    if (!last || !(*last == *e)) {
+                        last = *e;
+                        return e;
+                    }
+                }
+                return nullptr;
+            };
+        }) : std::function<Cursor()>([up = openCursor]() -> Cursor {
+            return [cursor = up(), seen = FlatHashSet<T>()]() mutable -> const T * {
+                while (const T *e = cursor()) {
+                    if (seen.insert(*e))
+                        return e;
+                }
+                return nullptr;
+            };
+        }));
+        s.isSorted = isSorted;
+        s.isUnique = true;
+        return s;
+    }
+
+    // Drops the first n elements. Directly over a container this only
+    // advances its begin iterator, in O(1) for vectors.
+    Stream<T, Container> skip(size_t n) {
+        std::function<Cursor()> open;
+        if (originalContainer) {
+            open = [original = originalContainer, n]() -> Cursor {
+                auto it = original->begin();
+                std::advance(it, std::min(n, original->size()));
+                return [it, end = original->end()]() mutable -> const T * {
+                    return it == end ? nullptr : &*it++;
+                };
+            };
+        } else {
+            open = [up = openCursor, n]() -> Cursor {
+                return [cursor = up(), n]() mutable -> const T * {
+                    for (; n > 0; n--) {
+                        if (!cursor())
+                            return nullptr;
+                    }
+                    return cursor();
+                };
+            };
+        }
+        return keepingOrder(std::move(open));
+    }
+
+    // Stops after n elements, without pulling any more from upstream.
+    Stream<T, Container> limit(size_t n) {
+        auto s = keepingOrder(openFirst ? std::function<Cursor()>([openFirst = openFirst, n]() -> Cursor {
+            return limited(openFirst(n), n);
+        }) : std::function<Cursor()>([up = openCursor, n]() -> Cursor {
+            return limited(up(), n);
+        }));
+        if (openFirst) {
+            s.openFirst = [openFirst = openFirst, n](size_t k) -> Cursor {
+                return limited(openFirst(std::min(n, k)), std::min(n, k));
+            };
         }
         return s;
     }
 
+    Stream<T, Container> takeWhile(std::function<bool(const T &)> func) {
+        return keepingOrder([up = openCursor, func]() -> Cursor {
+            return [cursor = up(), func, done = false]() mutable -> const T * {
+                if (done)
+                    return nullptr;
+                const T *e = cursor();
+                if (e && func(*e))
+                    return e;
+                done = true;
+                return nullptr;
+            };
+        });
+    }
+
+    Stream<T, Container> dropWhile(std::function<bool(const T &)> func) {
+        return keepingOrder([up = openCursor, func]() -> Cursor {
+            return [cursor = up(), func, dropping = true]() mutable -> const T * {
+                const T *e = cursor();
+                while (dropping && e && func(*e))
+                    e = cursor();
+                dropping = false;
+                return e;
+            };
+        });
+    }
+
+    // Stage boundary: the upstream stages run on a thread of their own and
+    // hand their elements over through a bounded lock-free SPSC queue, so that
+    // they work concurrently with the downstream ones.
+    Stream<T, Container> async(size_t capacity = 1024) {
+        return keepingOrder([up = openCursor, capacity]() -> Cursor {
+            return AsyncCursor<T>(up, capacity);
+        });
+    }
+
+    // Uniform sample of n elements (all of them if there are fewer), in no
+    // particular order. Reservoir sampling with Algorithm L: random numbers
+    // are only drawn to compute how many elements to skip until the next
+    // replacement, and directly over a container the skipped elements are
+    // jumped over by advancing an iterator.
+    Stream<T, Container> sample(size_t n, uint64_t seed = std::random_device()()) {
+        return Stream<T, Container>([skipper = openSkipper(), n, seed]() -> Cursor {
+            std::vector<T> reservoir;
+            auto next = skipper();
+            std::mt19937_64 random(seed);
+            while (reservoir.size() < n) {
+                const T *e = next(0);
+                if (!e)
+                    break;
+                reservoir.push_back(*e);
+            }
+            if (n > 0 && reservoir.size() == n) {
+                double w = std::exp(std::log(uniform(random)) / n);
+                while (const T *e = next(toSkip(std::log(uniform(random)) / std::log1p(-w)))) {
+                    reservoir[random() % n] = *e;
+                    w *= std::exp(std::log(uniform(random)) / n);
+                }
+            }
+            return [reservoir = std::move(reservoir), i = size_t(0)]() mutable -> const T * {
+                return i < reservoir.size() ? &reservoir[i++] : nullptr;
+            };
+        });
+    }
+
+    // Keeps each element with probability p. The gaps between kept elements
+    // are drawn from a geometric distribution instead of drawing a random
+    // number per element, and jumped over directly over a container.
+    Stream<T, Container> sampleFraction(double p, uint64_t seed = std::random_device()()) {
+        return keepingOrder([skipper = openSkipper(), p, seed]() -> Cursor {
+            return [next = skipper(), p, random = std::mt19937_64(seed)]() mutable -> const T * {
+                if (p >= 1.0)
+                    return next(0);
+                if (p <= 0.0)
+                    return nullptr;
+                return next(toSkip(std::log(uniform(random)) / std::log1p(-p)));
+            };
+        });
+    }
+
+    // Sorts the whole stream. When only the first k elements are pulled
+    // (limit(k), collect(k)), only the k smallest are kept and sorted instead.
+    template<typename Compare = std::less<T>>
+    Stream<T, Container> sorted(Compare cmp = Compare()) {
+        auto openFirst = [up = openCursor, cmp](size_t k) -> Cursor {
+            std::vector<T> elements;
+            Cursor cursor = up();
+            if (k > std::numeric_limits<size_t>::max() / 2) {
+                while (const T *e = cursor())
+                    elements.push_back(*e);
+            } else if (k > 0) {
+                // Keeps at most 2k candidates, cut back to the k smallest with
+                // nth_element when full: O(n) overall and O(k) memory.
+                // elements[k - 1] is the largest one kept since the last cut.
+                elements.reserve(std::min(2 * k, size_t(4096)));
+                bool cut = false;
+                while (const T *e = cursor()) {
+                    if (cut && !cmp(*e, elements[k - 1]))
+                        continue;
+                    elements.push_back(*e);
+                    if (elements.size() == 2 * k) {
+                        std::nth_element(elements.begin(), elements.begin() + (k - 1), elements.end(), cmp);
+                        elements.resize(k);
+                        cut = true;
+                    }
+                }
+                if (elements.size() > k) {
+                    std::nth_element(elements.begin(), elements.begin() + (k - 1), elements.end(), cmp);
+                    elements.resize(k);
+                }
+            }
+            std::sort(elements.begin(), elements.end(), cmp);
+            return [elements = std::move(elements), i = size_t(0)]() mutable -> const T * {
+                return i < elements.size() ? &elements[i++] : nullptr;
+            };
+        };
+        Stream<T, Container> s([openFirst]() -> Cursor {
+            return openFirst(std::numeric_limits<size_t>::max());
+        });
+        s.openFirst = openFirst;
+        // Other comparators may order unequal elements as equivalent (e.g. by
+        // key), which then don't end up adjacent to their equals
+        s.isSorted = std::is_same_v<Compare, std::less<T>> || std::is_same_v<Compare, std::greater<T>>;
+        s.isUnique = isUnique;
+        return s;
+    }
+
     Container<T> collect(int limit = -1) {
         Container<T> cont;
-        size_t _limit = limit == -1 ? originalContainerReference.size() : limit;
-        for (const auto &e : originalContainerReference) {
-            (cont.*Trait<Container<T>>::append)(e);
-            if (--_limit == 0)
+        Cursor cursor = openFirst && limit > 0 ? openFirst(limit) : openCursor();
+        int collected = 0;
+        while (const T *e = cursor()) {
+            (cont.*Trait<Container<T>>::append)(*e);
+            if (++collected == limit)
                 break;
         }
         return cont;
     }
 
     T sum(T startValue = 0) {
-        Container<T> collected = collect();
-        return std::accumulate(collected.begin(), collected.end(), startValue);
+        return reduce(startValue, std::plus<T>());
     }
 
     std::optional<T> findFirst(std::function<bool(const T &)> func) {
-        Container<T> lResult = collect();
-        for (const auto& value : originalContainerReference ) {
-            if (func(value))
-                return value;
+        Cursor cursor = openCursor();
+        while (const T *e = cursor()) {
+            if (func(*e))
+                return *e;
         }
         return std::nullopt;
     }
 
     std::optional<T> findAny() {
-        if (originalContainerReference.empty())
+        Cursor cursor = openCursor();
+        const T *e = cursor();
+        if (!e)
+            return std::nullopt;
+        return *e;
+    }
+
+    template<typename Compare = std::less<T>>
+    std::optional<T> min(Compare cmp = Compare()) {
+        if constexpr (std::is_same_v<Compare, std::less<T>>) {
+            if (auto bounds = originalBounds())
+                return bounds->first;
+        }
+        return best([&cmp](const T &candidate, const T &current) { return cmp(candidate, current); });
+    }
+
+    template<typename Compare = std::less<T>>
+    std::optional<T> max(Compare cmp = Compare()) {
+        if constexpr (std::is_same_v<Compare, std::less<T>>) {
+            if (auto bounds = originalBounds())
+                return bounds->second;
+        }
+        return best([&cmp](const T &candidate, const T &current) { return cmp(current, candidate); });
+    }
+
+    std::optional<std::pair<T, T>> minMax() {
+        if (auto bounds = originalBounds())
+            return bounds;
+        Cursor cursor = openCursor();
+        const T *e = cursor();
+        if (!e)
             return std::nullopt;
-        return originalContainerReference.front();
+        std::pair<T, T> bounds(*e, *e);
+        while ((e = cursor())) {
+            if (*e < bounds.first)
+                bounds.first = *e;
+            else if (bounds.second < *e)
+                bounds.second = *e;
+        }
+        return bounds;
+    }
+
+    // Count, sum, min, max, mean and variance in one pass. Elements are
+    // summarized by blocks, read in place from a vector source and copied in
+    // a small buffer otherwise.
+    SummaryStatistics<T> summaryStatistics() {
+        constexpr size_t kBlockSize = 1024;
+        SummaryStatistics<T> stats;
+        if constexpr (Trait<Container<T>>::contiguous) {
+            if (originalContainer) {
+                const T *data = originalContainer->data();
+                size_t size = originalContainer->size();
+                for (size_t i = 0; i < size; i += kBlockSize)
+                    stats.acceptBlock(data + i, std::min(kBlockSize, size - i));
+                return stats;
+            }
+        }
+        std::vector<T> block;
+        block.reserve(kBlockSize);
+        Cursor cursor = openCursor();
+        while (const T *e = cursor()) {
+            block.push_back(*e);
+            if (block.size() == kBlockSize) {
+                stats.acceptBlock(block.data(), block.size());
+                block.clear();
+            }
+        }
+        stats.acceptBlock(block.data(), block.size());
+        return stats;
+    }
+
+    // Element with the smallest key(element), key being computed once per element.
+    template<typename F>
+    std::optional<T> minBy(F key) {
+        return bestBy(key, [](const auto &candidate, const auto &current) { return candidate < current; });
+    }
+
+    template<typename F>
+    std::optional<T> maxBy(F key) {
+        return bestBy(key, [](const auto &candidate, const auto &current) { return current < candidate; });
+    }
+
+    // Aggregates the elements of each key(element) group with downstream in a
+    // single pass, directly into a flat hash map of accumulators: elements are
+    // only stored when the downstream collector keeps them (toVector).
+    template<typename F, typename Collector = Collectors::ToVector>
+    auto groupingBy(F key, Collector downstream = Collector()) {
+        using K = std::decay_t<std::invoke_result_t<F, const T &>>;
+        using Acc = decltype(downstream.template init<T>());
+        using Res = decltype(downstream.finish(std::declval<Acc>()));
+        FlatHashMap<K, Acc> groups;
+        Cursor cursor = openCursor();
+        while (const T *e = cursor()) {
+            auto group = groups.tryEmplace(key(*e), downstream.template init<T>()).first;
+            downstream.accumulate(*group, *e);
+        }
+        if constexpr (std::is_same_v<Acc, Res>) {
+            for (auto &group : groups)
+                group.second = downstream.finish(std::move(group.second));
+            return groups;
+        } else {
+            FlatHashMap<K, Res> results;
+            results.reserve(groups.size());
+            for (auto &group : groups)
+                results.tryEmplace(group.first, downstream.finish(std::move(group.second)));
+            return results;
+        }
+    }
+
+    // Aggregates of the windows of size elements starting every step elements
+    // (see WindowCursor), combined with the associative op of identity.
+    template<typename R, typename Op>
+    Stream<R, Container> window(size_t size, size_t step, R identity, Op op) {
+        return windowOf<R>(size, step, SlidingMonoid<R, Op>(identity, op));
+    }
+
+    Stream<T, Container> windowSum(size_t size, size_t step) {
+        if constexpr (std::is_integral_v<T>)
+            return windowOf<T>(size, step, SlidingSum<T>());
+        else
+            return window(size, step, T(), std::plus<T>());
+    }
+
+    Stream<T, Container> windowMin(size_t size, size_t step) {
+        return windowOf<T>(size, step, SlidingExtremum<T, std::less<T>>());
+    }
+
+    Stream<T, Container> windowMax(size_t size, size_t step) {
+        return windowOf<T>(size, step, SlidingExtremum<T, std::greater<T>>());
+    }
+
+    // Pairs the elements of both streams by position, up to the end of the
+    // shortest one.
+    template<typename U, template <class...> typename C>
+    Stream<std::pair<T, U>, Container> zip(const Stream<U, C> &other) {
+        using X = std::pair<T, U>;
+        return Stream<X, Container>([left = openCursor, right = other.openCursor]() -> typename Stream<X, Container>::Cursor {
+            return [leftCursor = left(), rightCursor = right(), current = std::optional<X>()]() mutable -> const X * {
+                const T *l = leftCursor();
+                if (!l)
+                    return nullptr;
+                const U *r = rightCursor();
+                if (!r)
+                    return nullptr;
+                current.emplace(*l, *r);
+                return &*current;
+            };
+        });
+    }
+
+    // Pairs each element with its position: (element, index)
+    Stream<std::pair<T, size_t>, Container> zipWithIndex() {
+        return map([i = size_t(0)](const T &e) mutable { return std::make_pair(e, i++); });
+    }
+
+    // Same as zipWithIndex, with the index first: (index, element)
+    Stream<std::pair<size_t, T>, Container> enumerate() {
+        return map([i = size_t(0)](const T &e) mutable { return std::make_pair(i++, e); });
+    }
+
+    // Inner hash join: combine(left, right) for every pair of elements with
+    // equal keys. The table is built on other, unless both sides are plain
+    // containers and this one is smaller; the other side is streamed, so it
+    // may be infinite. The output order is unspecified.
+    template<typename U, template <class...> typename C, typename LK, typename RK, typename F>
+    auto join(const Stream<U, C> &other, LK leftKey, RK rightKey, F combine) {
+        using K = std::decay_t<std::invoke_result_t<LK, const T &>>;
+        using X = std::decay_t<std::invoke_result_t<F, const T &, const U &>>;
+        using XCursor = typename Stream<X, Container>::Cursor;
+        bool buildLeft = originalContainer && other.originalContainer
+                         && originalContainer->size() < other.originalContainer->size();
+        if (buildLeft) {
+            return Stream<X, Container>([build = openCursor, probe = other.openCursor, leftKey, rightKey, combine]() -> XCursor {
+                return HashJoinCursor<T, U, K, X>(build(), leftKey, probe(), rightKey,
+                                                  [combine](const U &r, const T *l) { return combine(*l, r); }, false);
+            });
+        }
+        return Stream<X, Container>([probe = openCursor, build = other.openCursor, leftKey, rightKey, combine]() -> XCursor {
+            return HashJoinCursor<U, T, K, X>(build(), rightKey, probe(), leftKey,
+                                              [combine](const T &l, const U *r) { return combine(l, *r); }, false);
+        });
+    }
+
+    // Inner join of two streams already in ascending key order, e.g. std::set
+    // sources or sorted() ones joined on their elements: both are walked in
+    // lockstep without any table. Only the run of right elements sharing the
+    // current key is kept, a single element when keys are unique.
+    template<typename U, template <class...> typename C, typename LK, typename RK, typename F>
+    auto mergeJoin(const Stream<U, C> &other, LK leftKey, RK rightKey, F combine) {
+        using K = std::decay_t<std::invoke_result_t<LK, const T &>>;
+        using X = std::decay_t<std::invoke_result_t<F, const T &, const U &>>;
+        return Stream<X, Container>([left = openCursor, right = other.openCursor, leftKey, rightKey, combine]() -> typename Stream<X, Container>::Cursor {
+            return [leftCursor = left(), rightCursor = right(), leftKey, rightKey, combine,
+                    l = static_cast<const T *>(nullptr), r = static_cast<const U *>(nullptr), rk = std::optional<K>(), started = false,
+                    run = std::vector<U>(), runKey = std::optional<K>(), runIndex = size_t(0),
+                    current = std::optional<X>()]() mutable -> const X * {
+                if (!started) {
+                    started = true;
+                    if ((r = rightCursor()))
+                        rk.emplace(rightKey(*r));
+                }
+                for (;;) {
+                    if (l && runIndex < run.size()) {
+                        current.emplace(combine(*l, run[runIndex++]));
+                        return &*current;
+                    }
+                    if (!(l = leftCursor()))
+                        return nullptr;
+                    K lk = leftKey(*l);
+                    runIndex = 0;
+                    if (runKey && *runKey == lk)
+                        continue;
+                    while (r && *rk < lk) {
+                        if ((r = rightCursor()))
+                            rk.emplace(rightKey(*r));
+                    }
+                    run.clear();
+                    runKey.reset();
+                    while (r && *rk == lk) {
+                        run.push_back(*r);
+                        if ((r = rightCursor()))
+                            rk.emplace(rightKey(*r));
+                    }
+                    if (!run.empty())
+                        runKey.emplace(std::move(lk));
+                }
+            };
+        });
+    }
+
+    // Like join, but every element of this stream without a match is also
+    // combined once with a nullptr right element.
+    template<typename U, template <class...> typename C, typename LK, typename RK, typename F>
+    auto leftOuterJoin(const Stream<U, C> &other, LK leftKey, RK rightKey, F combine) {
+        using K = std::decay_t<std::invoke_result_t<LK, const T &>>;
+        using X = std::decay_t<std::invoke_result_t<F, const T &, const U *>>;
+        return Stream<X, Container>([probe = openCursor, build = other.openCursor, leftKey, rightKey, combine]() -> typename Stream<X, Container>::Cursor {
+            return HashJoinCursor<U, T, K, X>(build(), rightKey, probe(), leftKey, combine, true);
+        });
+    }
+
+    // Elements of this stream having a match in other. Only the keys of other
+    // are kept in memory.
+    template<typename U, template <class...> typename C, typename LK, typename RK>
+    Stream<T, Container> semiJoin(const Stream<U, C> &other, LK leftKey, RK rightKey) {
+        return keyJoin(other, leftKey, rightKey, true);
+    }
+
+    // Elements of this stream without any match in other.
+    template<typename U, template <class...> typename C, typename LK, typename RK>
+    Stream<T, Container> antiJoin(const Stream<U, C> &other, LK leftKey, RK rightKey) {
+        return keyJoin(other, leftKey, rightKey, false);
+    }
+
+    // Splits the stream in one pass: first holds the elements matching func,
+    // second the others.
+    std::pair<Container<T>, Container<T>> partitioningBy(std::function<bool(const T &)> func) {
+        std::pair<Container<T>, Container<T>> parts;
+        Cursor cursor = openCursor();
+        while (const T *e = cursor()) {
+            auto &cont = func(*e) ? parts.first : parts.second;
+            (cont.*Trait<Container<T>>::append)(*e);
+        }
+        return parts;
+    }
+
+    template<typename Collector>
+    auto partitioningBy(std::function<bool(const T &)> func, Collector downstream) {
+        auto matching = downstream.template init<T>();
+        auto others = downstream.template init<T>();
+        Cursor cursor = openCursor();
+        while (const T *e = cursor())
+            downstream.accumulate(func(*e) ? matching : others, *e);
+        return std::make_pair(downstream.finish(std::move(matching)), downstream.finish(std::move(others)));
     }
 
     static Stream<T, Container> makeStream(const Container<T>& original) {
@@ -97,17 +761,596 @@ public:
         return oStream;
     }
 
+    // Elements popped from channel until it is closed and drained. Several
+    // streams may consume the same channel concurrently.
+    static Stream<T, Container> makeStream(Channel<T> &channel) {
+        return Stream<T, Container>([&channel]() -> Cursor {
+            return [&channel, current = std::optional<T>()]() mutable -> const T * {
+                current = channel.pop();
+                return current ? &*current : nullptr;
+            };
+        });
+    }
+
+    // from, from + step, ... up to to (excluded), no container involved.
+    static Stream<T, Container> range(T from, T to, T step = 1) {
+        if (step == T())
+            throw std::invalid_argument("range step must not be zero");
+        // Whether value + step is still before to, checked without computing
+        // anything beyond the bounds of T
+        auto hasNext = [to, step](const T &value) {
+            if (step > T())
+                return !(to < std::numeric_limits<T>::lowest() + step) && value < to - step;
+            return !(std::numeric_limits<T>::max() + step < to) && to - step < value;
+        };
+        Stream<T, Container> s([from, to, step, hasNext]() -> Cursor {
+            return [current = from, next = from, more = step > T() ? from < to : to < from,
+                    step, hasNext]() mutable -> const T * {
+                if (!more)
+                    return nullptr;
+                current = next;
+                more = hasNext(current);
+                if (more)
+                    next = current + step;
+                return &current;
+            };
+        });
+        s.isSorted = true;
+        s.isUnique = true;
+        return s;
+    }
+
+    // Infinite stream of seed, func(seed), func(func(seed))...
+    template<typename F>
+    static Stream<T, Container> iterate(T seed, F func) {
+        return Stream<T, Container>([seed, func]() -> Cursor {
+            return [current = std::optional<T>(), seed, func]() mutable -> const T * {
+                if (current)
+                    current = func(*current);
+                else
+                    current = seed;
+                return &*current;
+            };
+        });
+    }
+
+#ifdef CPPSTREAMS_HAS_COROUTINES
+    // Stream over the values co_yield-ed by the coroutine returned by func(),
+    // which is called again each time the stream runs. Values are pulled one
+    // at a time, the coroutine only runs up to its next co_yield.
+    template<typename F>
+    static Stream<T, Container> fromGenerator(F func) {
+        return Stream<T, Container>([func]() -> Cursor {
+            auto generator = std::make_shared<Generator<T>>(func());
+            return [generator]() { return generator->next(); };
+        });
+    }
+
+    // Runs the stream as a coroutine, producing an element per resumption
+    Generator<T> toGenerator() const {
+        return generatorOf(openCursor);
+    }
+#endif
+
+    // Infinite stream of the values returned by successive func() calls
+    template<typename F>
+    static Stream<T, Container> generate(F func) {
+        return Stream<T, Container>([func]() -> Cursor {
+            return [current = std::optional<T>(), func]() mutable -> const T * {
+                current = func();
+                return &*current;
+            };
+        });
+    }
+
+#ifdef CPPSTREAMS_HAS_MMAP
+    // Lines of the file at path, as views into a read-only mapping of it: no
+    // line is copied nor allocated. The views stay valid as long as the
+    // stream (or a copy of it) lives: map them to std::string to keep them
+    // longer. To read the file from several threads, each one streams the
+    // part-th of parts slices, cut at line boundaries.
+    static Stream<T, Container> lines(const std::string &path, size_t part = 0, size_t parts = 1) {
+        static_assert(std::is_same_v<T, std::string_view>, "lines streams std::string_view elements");
+        auto file = std::make_shared<MappedFile>(path);
+        auto slice = file->lineSlice(part, parts);
+        return Stream<T, Container>([file, slice]() -> Cursor {
+            return [file, lines = LineCursor(file->data() + slice.first, file->data() + slice.second)]() mutable {
+                return lines();
+            };
+        });
+    }
+
+    // Fixed size binary records of the file at path, starting at byte offset,
+    // read from a mapping of it rather than loaded in memory. T must be
+    // trivially copyable, and the file hold its raw bytes.
+    static Stream<T, Container> records(const std::string &path, size_t offset = 0) {
+        static_assert(std::is_trivially_copyable_v<T>, "records must be trivially copyable");
+        auto file = std::make_shared<MappedFile>(path, true);
+        offset = std::min(offset, file->size());
+        return Stream<T, Container>([file, offset]() -> Cursor {
+            return [file, records = RecordCursor<T>(file->data() + offset, file->data() + file->size())]() mutable {
+                return records();
+            };
+        });
+    }
+
+    // Rows of the CSV file at path, as CsvRow views into a mapping of it,
+    // valid as long as the stream lives. Fields are separated by delimiter
+    // (e.g. '\t' for TSV) and may be quoted. A header line is streamed like
+    // the other rows, skip(1) drops it.
+    static Stream<T, Container> csv(const std::string &path, char delimiter = ',') {
+        static_assert(std::is_same_v<T, CsvRow>, "csv streams CsvRow elements");
+        auto file = std::make_shared<MappedFile>(path);
+        return Stream<T, Container>([file, delimiter]() -> Cursor {
+            return [file, rows = CsvCursor(file->data(), file->data() + file->size(), delimiter)]() mutable {
+                return rows();
+            };
+        });
+    }
+
+    // Lines of the JSON Lines file at path, as JsonValue views into a mapping
+    // of it, blank lines skipped. Nothing is parsed up front: the fields are
+    // only looked for when get() is called, in the lambdas that need them.
+    static Stream<T, Container> jsonLines(const std::string &path) {
+        static_assert(std::is_same_v<T, JsonValue>, "jsonLines streams JsonValue elements");
+        auto file = std::make_shared<MappedFile>(path);
+        return Stream<T, Container>([file]() -> Cursor {
+            return [file, lines = LineCursor(file->data(), file->data() + file->size()),
+                    current = JsonValue()]() mutable -> const T * {
+                while (const std::string_view *line = lines()) {
+                    current = JsonValue(*line);
+                    if (current)
+                        return &current;
+                }
+                return nullptr;
+            };
+        });
+    }
+#endif
+
+    // Estimated number of distinct elements, from a HyperLogLog sketch of
+    // 2^precision bytes (about 0.8% error with the default 16KiB).
+    size_t approxCountDistinct(int precision = 14) {
+        if (isUnique)
+            return count();
+        HyperLogLog sketch(precision);
+        Cursor cursor = openCursor();
+        while (const T *e = cursor())
+            sketch.add(FastHash()(*e));
+        return static_cast<size_t>(std::llround(sketch.estimate()));
+    }
+
+    // Approximate values at the given ranks (e.g. {0.5, 0.99}) from a KLL
+    // QuantileSketch: rank error of about 1.7 / k, in O(k) memory.
+    std::vector<double> approxQuantiles(const std::vector<double> &ranks, size_t k = 200) {
+        QuantileSketch sketch(k);
+        Cursor cursor = openCursor();
+        while (const T *e = cursor())
+            sketch.add(static_cast<double>(*e));
+        return sketch.quantiles(ranks);
+    }
+
+    // Pushes every element into channel, waiting while it is full. Stops if
+    // the channel gets closed, returns the number of elements pushed.
+    size_t pushTo(Channel<T> &channel) {
+        size_t pushed = 0;
+        Cursor cursor = openCursor();
+        while (const T *e = cursor()) {
+            if (!channel.push(*e))
+                break;
+            pushed++;
+        }
+        return pushed;
+    }
+
     size_t count() {
-        return originalContainerReference.size();
+        if (originalContainer)
+            return originalContainer->size();
+        size_t n = 0;
+        Cursor cursor = openCursor();
+        while (cursor())
+            n++;
+        return n;
     }
 
     template <class Res, class BinaryOperation>
     Res reduce(Res init, BinaryOperation op) {
-        return accumulate(originalContainerReference.begin(), originalContainerReference.end(), init, op);
+        Cursor cursor = openCursor();
+        while (const T *e = cursor())
+            init = op(std::move(init), *e);
+        return init;
     }
+
+    // Calls func on every element, without building any container
+    template<typename F>
+    void forEach(F func) {
+        Cursor cursor = openCursor();
+        while (const T *e = cursor())
+            func(*e);
+    }
+
+#ifdef CPPSTREAMS_HAS_WRITEV
+    // Writes the elements to fd as text, each one followed by separator, with
+    // a writev per megabyte of output. Returns the number of elements
+    // written; fd is left open. Throws std::system_error when writing fails.
+    size_t writeTo(int fd, std::string_view separator = "\n") {
+        OutputBuffer output(fd);
+        size_t n = 0;
+        Cursor cursor = openCursor();
+        while (const T *e = cursor()) {
+            output.append(*e);
+            output.append(separator);
+            n++;
+        }
+        output.flush();
+        return n;
+    }
+
+    // Writes the elements to the file at path, created or truncated, one
+    // element per line. Returns the number of lines written.
+    size_t writeLines(const std::string &path) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+        size_t n;
+        try {
+            n = writeTo(fd);
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+        if (::close(fd) != 0)
+            throw std::system_error(errno, std::generic_category(), "cannot close " + path);
+        return n;
+    }
+#endif
+private:
+    // Stream over a subsequence of this one's elements, with the same flags
+    Stream<T, Container> keepingOrder(std::function<Cursor()> open) const {
+        Stream<T, Container> s(std::move(open));
+        s.isSorted = isSorted;
+        s.isUnique = isUnique;
+        return s;
+    }
+
+#ifdef CPPSTREAMS_HAS_COROUTINES
+    static Generator<T> generatorOf(std::function<Cursor()> open) {
+        Cursor cursor = open();
+        while (const T *e = cursor())
+            co_yield *e;
+    }
+#endif
+
+    // Opens functions returning the element following the given number of
+    // skipped ones, or nullptr at the end of the stream.
+    std::function<std::function<const T *(size_t)>()> openSkipper() const {
+        if (originalContainer) {
+            return [original = originalContainer]() -> std::function<const T *(size_t)> {
+                return [it = original->begin(), remaining = original->size()](size_t skip) mutable -> const T * {
+                    if (skip >= remaining) {
+                        remaining = 0;
+                        return nullptr;
+                    }
+                    std::advance(it, skip);
+                    remaining -= skip + 1;
+                    return &*it++;
+                };
+            };
+        }
+        return [up = openCursor]() -> std::function<const T *(size_t)> {
+            return [cursor = up()](size_t skip) mutable -> const T * {
+                for (; skip > 0; skip--) {
+                    if (!cursor())
+                        return nullptr;
+                }
+                return cursor();
+            };
+        };
+    }
+
+    // Uniform double in (0, 1]
+    static double uniform(std::mt19937_64 &random) {
+        return ((random() >> 11) + 1) * 0x1p-53;
+    }
+
+    static size_t toSkip(double gap) {
+        return gap < 1e18 ? static_cast<size_t>(gap) : std::numeric_limits<size_t>::max();
+    }
+
+    static Cursor limited(Cursor cursor, size_t n) {
+        return [cursor = std::move(cursor), n]() mutable -> const T * {
+            if (n == 0)
+                return nullptr;
+            n--;
+            return cursor();
+        };
+    }
+
+    template<typename R, typename State>
+    Stream<R, Container> windowOf(size_t size, size_t step, State state) {
+        if (size == 0 || step == 0)
+            throw std::invalid_argument("window size and step must be positive");
+        return Stream<R, Container>([up = openCursor, size, step, state]() -> typename Stream<R, Container>::Cursor {
+            return WindowCursor<T, R, State>(up(), size, step, state);
+        });
+    }
+
+    template<typename U, template <class...> typename C, typename LK, typename RK>
+    Stream<T, Container> keyJoin(const Stream<U, C> &other, LK leftKey, RK rightKey, bool matching) {
+        using K = std::decay_t<std::invoke_result_t<LK, const T &>>;
+        return keepingOrder([up = openCursor, build = other.openCursor, leftKey, rightKey, matching]() -> Cursor {
+            FlatHashSet<K> keys;
+            auto buildCursor = build();
+            while (const U *e = buildCursor())
+                keys.insert(rightKey(*e));
+            return [cursor = up(), keys = std::move(keys), leftKey, matching]() mutable -> const T * {
+                while (const T *e = cursor()) {
+                    if (keys.contains(leftKey(*e)) == matching)
+                        return e;
+                }
+                return nullptr;
+            };
+        });
+    }
+
+    // First element for which better(element, previous best) never held.
+    template<typename Better>
+    std::optional<T> best(Better better) {
+        Cursor cursor = openCursor();
+        const T *e = cursor();
+        if (!e)
+            return std::nullopt;
+        T current = *e;
+        while ((e = cursor())) {
+            if (better(*e, current))
+                current = *e;
+        }
+        return current;
+    }
+
+    template<typename F, typename Better>
+    std::optional<T> bestBy(F key, Better better) {
+        Cursor cursor = openCursor();
+        const T *e = cursor();
+        if (!e)
+            return std::nullopt;
+        T current = *e;
+        auto currentKey = key(current);
+        while ((e = cursor())) {
+            auto k = key(*e);
+            if (better(k, currentKey)) {
+                current = *e;
+                currentKey = std::move(k);
+            }
+        }
+        return current;
+    }
+
+    // Smallest and largest elements by operator< when they can be found
+    // without running the pipeline: from the ends of a std::set source, or
+    // with a branchless loop the compiler can vectorize over a vector of
+    // arithmetic values.
+    std::optional<std::pair<T, T>> originalBounds() const {
+        if (!originalContainer || originalContainer->empty())
+            return std::nullopt;
+        if constexpr (Trait<Container<T>>::sortedUnique) {
+            return std::make_pair(*originalContainer->begin(), *originalContainer->rbegin());
+        } else if constexpr (Trait<Container<T>>::contiguous && std::is_arithmetic_v<T>) {
+            const T *data = originalContainer->data();
+            size_t size = originalContainer->size();
+            T lowest = data[0];
+            T highest = data[0];
+            for (size_t i = 1; i < size; i++) {
+                lowest = data[i] < lowest ? data[i] : lowest;
+                highest = highest < data[i] ? data[i] : highest;
+            }
+            return std::make_pair(lowest, highest);
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    template <class> struct IsStream : std::false_type {};
+    template <typename Y, template <typename...> class Z>
+    struct IsStream<Stream<Y, Z>> : std::true_type {
+        using value_type = Y;
+    };
+
+#ifdef CPPSTREAMS_HAS_COROUTINES
+    template <class> struct IsGenerator : std::false_type {};
+    template <typename Y>
+    struct IsGenerator<Generator<Y>> : std::true_type {
+        using value_type = Y;
+    };
+#endif
+
+    // Set while no stage has been applied, for operations able to shortcut.
+    const Container<T> *originalContainer = nullptr;
+    std::function<Cursor()> openCursor;
+    // Opens a cursor knowing that at most the given number of elements will
+    // be pulled from it, for stages able to do less work in that case.
+    std::function<Cursor(size_t)> openFirst;
+    // Equal elements are adjacent / there are no duplicates
+    bool isSorted = false;
+    bool isUnique = false;
+};
+
+// Container wrapper notifying its observers of every insert/erase, so that
+// IncrementalStream results can be maintained from deltas only.
+template<typename T, template <class...> typename Container>
+class ObservableContainer {
+public:
+    // Called with the affected element and true on insert, false on erase.
+    using Observer = std::function<void(const T &, bool)>;
+    using Subscription = typename std::list<Observer>::iterator;
+
+    ObservableContainer() = default;
+    explicit ObservableContainer(Container<T> initial) : container(std::move(initial)) {}
+
+    ObservableContainer(const ObservableContainer &) = delete;
+    ObservableContainer &operator=(const ObservableContainer &) = delete;
+
+    void insert(const T &value) {
+        size_t before = container.size();
+        (container.*Trait<Container<T>>::append)(value);
+        // std::set silently drops duplicates, observers must not see them
+        if (container.size() != before)
+            notify(value, true);
+    }
+
+    bool erase(const T &value) {
+        if (!Trait<Container<T>>::erase(container, value))
+            return false;
+        notify(value, false);
+        return true;
+    }
+
+    const Container<T> &get() const {
+        return container;
+    }
+
+    Subscription subscribe(Observer observer) {
+        return observers.insert(observers.end(), std::move(observer));
+    }
+
+    void unsubscribe(Subscription subscription) {
+        observers.erase(subscription);
+    }
+
+private:
+    void notify(const T &value, bool inserted) {
+        for (const auto &observer : observers)
+            observer(value, inserted);
+    }
+
+    Container<T> container;
+    std::list<Observer> observers;
+};
+
+// Result of an IncrementalStream terminal operation. It stays subscribed to
+// the source ObservableContainer for its whole lifetime and must not outlive it.
+template<typename R>
+class IncrementalView {
+public:
+    IncrementalView(std::shared_ptr<R> state, std::function<void()> detach)
+        : state(std::move(state)), detach(std::move(detach)) {}
+
+    IncrementalView(IncrementalView &&other) noexcept
+        : state(std::move(other.state)), detach(std::exchange(other.detach, nullptr)) {}
+
+    IncrementalView(const IncrementalView &) = delete;
+    IncrementalView &operator=(const IncrementalView &) = delete;
+    IncrementalView &operator=(IncrementalView &&) = delete;
+
+    ~IncrementalView() {
+        if (detach)
+            detach();
+    }
+
+    const R &get() const {
+        return *state;
+    }
+
+private:
+    std::shared_ptr<R> state;
+    std::function<void()> detach;
+};
+
+// Stream over an ObservableContainer whose results are kept up to date on
+// insert/erase: each change only goes through the filter/map stages once.
+template<typename T, template <class...> typename Container>
+class IncrementalStream {
+    template <typename Y, template <typename...> class Z>
+    friend class IncrementalStream;
+
+    using Observer = std::function<void(const T &, bool)>;
+    // Replays the current content as inserts to the observer, then forwards
+    // further changes. Returns the function detaching the observer.
+    using Attach = std::function<std::function<void()>(Observer)>;
+
+    explicit IncrementalStream (Attach attach) : attach(std::move(attach)) {}
+public:
+    template<template <class...> typename Source>
+    static IncrementalStream<T, Container> makeStream(ObservableContainer<T, Source> &source) {
+        return IncrementalStream<T, Container>([&source](Observer observer) -> std::function<void()> {
+            for (const auto &e : source.get())
+                observer(e, true);
+            auto subscription = source.subscribe(std::move(observer));
+            return [&source, subscription] { source.unsubscribe(subscription); };
+        });
+    }
+
+    template<typename F>
+    auto map(F func) -> IncrementalStream<std::decay_t<std::invoke_result_t<F, const T &>>, Container> {
+        using X = std::decay_t<std::invoke_result_t<F, const T &>>;
+        return IncrementalStream<X, Container>([up = attach, func](std::function<void(const X &, bool)> observer) {
+            return up([observer = std::move(observer), func](const T &e, bool inserted) {
+                observer(func(e), inserted);
+            });
+        });
+    }
+
+    IncrementalStream<T, Container> filter(std::function<bool(const T &)> func) {
+        return IncrementalStream<T, Container>([up = attach, func](Observer observer) {
+            return up([observer = std::move(observer), func](const T &e, bool inserted) {
+                if (func(e))
+                    observer(e, inserted);
+            });
+        });
+    }
+
+    // inverse must undo op: inverse(op(acc, e), e) == acc
+    template <class Res, class BinaryOperation, class InverseOperation>
+    IncrementalView<Res> reduce(Res init, BinaryOperation op, InverseOperation inverse) {
+        auto state = std::make_shared<Res>(std::move(init));
+        auto detach = attach([acc = state.get(), op, inverse](const T &e, bool inserted) {
+            *acc = inserted ? op(std::move(*acc), e) : inverse(std::move(*acc), e);
+        });
+        return IncrementalView<Res>(std::move(state), std::move(detach));
+    }
+
+    IncrementalView<T> sum(T startValue = 0) {
+        return reduce(startValue, std::plus<T>(), std::minus<T>());
+    }
+
+    IncrementalView<size_t> count() {
+        return reduce(size_t(0),
+                      [](size_t n, const T &) { return n + 1; },
+                      [](size_t n, const T &) { return n - 1; });
+    }
+
+    IncrementalView<Container<T>> collect() {
+        auto state = std::make_shared<Container<T>>();
+        std::function<void()> detach;
+        if constexpr (Trait<Container<T>>::sortedUnique) {
+            // Several source elements may give the same value (duplicates in
+            // the source, or a map): it leaves the set with the last of them
+            auto counts = std::make_shared<std::map<T, size_t>>();
+            detach = attach([cont = state.get(), counts](const T &e, bool inserted) {
+                if (inserted) {
+                    if ((*counts)[e]++ == 0)
+                        (cont->*Trait<Container<T>>::append)(e);
+                } else {
+                    auto it = counts->find(e);
+                    if (it != counts->end() && --it->second == 0) {
+                        counts->erase(it);
+                        Trait<Container<T>>::erase(*cont, e);
+                    }
+                }
+            });
+        } else {
+            detach = attach([cont = state.get()](const T &e, bool inserted) {
+                if (inserted)
+                    (cont->*Trait<Container<T>>::append)(e);
+                else
+                    Trait<Container<T>>::erase(*cont, e);
+            });
+        }
+        return IncrementalView<Container<T>>(std::move(state), std::move(detach));
+    }
+
 private:
-    std::unique_ptr<Container<T>> internalContainer;
-    const Container<T> & originalContainerReference;
+    Attach attach;
 };
 
 
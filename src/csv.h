@@ -0,0 +1,140 @@
+#ifndef CPPSTREAMS_CSV_H
+#define CPPSTREAMS_CSV_H
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "simd_scan.h"
+
+// Fields of a CSV row, as views into the parsed text. Quoted fields are given
+// without their enclosing quotes, unescaped() also turns their doubled quotes
+// back into single ones.
+class CsvRow {
+public:
+    using const_iterator = std::vector<std::string_view>::const_iterator;
+
+    size_t size() const {
+        return fields.size();
+    }
+
+    std::string_view operator[](size_t i) const {
+        return fields[i];
+    }
+
+    const_iterator begin() const {
+        return fields.begin();
+    }
+
+    const_iterator end() const {
+        return fields.end();
+    }
+
+    // Field i parsed as a number, which must span the whole field
+    template<typename V>
+    V as(size_t i) const {
+        static_assert(std::is_arithmetic_v<V> && !std::is_same_v<V, bool>, "CSV fields are parsed as numbers");
+        V value{};
+        if (!parseNumber(fields[i], value))
+            throw std::invalid_argument("CSV field is not a number: " + std::string(fields[i]));
+        return value;
+    }
+
+    std::string unescaped(size_t i) const {
+        std::string text;
+        text.reserve(fields[i].size());
+        for (size_t j = 0; j < fields[i].size(); j++) {
+            text += fields[i][j];
+            if (fields[i][j] == '"' && j + 1 < fields[i].size() && fields[i][j + 1] == '"')
+                j++;
+        }
+        return text;
+    }
+
+private:
+    friend class CsvCursor;
+
+    std::vector<std::string_view> fields;
+};
+
+// Rows of the CSV text in [begin, end), with RFC 4180 quoting: delimiters and
+// newlines between double quotes belong to the field. Lines may end with
+// "\r\n", blank lines are skipped. The text is scanned a block of 64 bytes at
+// a time: quote, delimiter and newline masks are built with SIMD compares,
+// and the quoted regions are the prefix XOR of the quote mask, carried from a
+// block to the next, so that the structural characters of the block are
+// (delimiters | newlines) & ~quoted, visited with a count trailing zeros each.
+class CsvCursor {
+public:
+    CsvCursor(const char *begin, const char *end, char delimiter)
+        : blocks(begin, end), fieldStart(begin), end(end), delimiter(delimiter) {}
+
+    const CsvRow *operator()() {
+        row.fields.clear();
+        for (;;) {
+            while (!structurals) {
+                if (!nextBlock()) {
+                    // Last line, without newline
+                    if (fieldStart == end && row.fields.empty())
+                        return nullptr;
+                    addField(fieldStart, end, true);
+                    fieldStart = end;
+                    return &row;
+                }
+            }
+            const char *separator = blockStart + trailingZeros(structurals);
+            structurals &= structurals - 1;
+            const char *start = fieldStart;
+            bool lineEnd = *separator == '\n';
+            addField(start, separator, lineEnd);
+            fieldStart = separator + 1;
+            if (!lineEnd)
+                continue;
+            if (row.fields.size() == 1 && row.fields[0].empty() && (separator == start || *start == '\r')) {
+                row.fields.clear();
+                continue;
+            }
+            return &row;
+        }
+    }
+
+private:
+    bool nextBlock() {
+        size_t length;
+        const char *block = blocks.next(length);
+        if (!block)
+            return false;
+        uint64_t quoted = prefixXor(matchMask(block, '"')) ^ insideQuotes;
+        insideQuotes = uint64_t(0) - (quoted >> 63);
+        structurals = (matchMask(block, delimiter) | matchMask(block, '\n')) & ~quoted;
+        if (length < kScanBlockSize)
+            structurals &= (uint64_t(1) << length) - 1;
+        blockStart = blocks.blockStart();
+        return true;
+    }
+
+    void addField(const char *begin, const char *end, bool lineEnd) {
+        if (lineEnd && end != begin && end[-1] == '\r')
+            end--;
+        if (end - begin >= 2 && *begin == '"' && end[-1] == '"') {
+            begin++;
+            end--;
+        }
+        row.fields.emplace_back(begin, static_cast<size_t>(end - begin));
+    }
+
+    BlockReader blocks;
+    const char *fieldStart;
+    const char *end;
+    char delimiter;
+    const char *blockStart = nullptr;
+    // Structural characters of the current block not visited yet
+    uint64_t structurals = 0;
+    // All ones when the previous block ended inside quotes
+    uint64_t insideQuotes = 0;
+    CsvRow row;
+};
+
+#endif //CPPSTREAMS_CSV_H
@@ -0,0 +1,221 @@
+#ifndef CPPSTREAMS_FLAT_HASH_MAP_H
+#define CPPSTREAMS_FLAT_HASH_MAP_H
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// std::hash is the identity for integers on most implementations, which is
+// a poor fit for power of two tables: the result is always mixed (splitmix64
+// finalizer) so that every bit depends on the whole key.
+struct FastHash {
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    template<typename T>
+    uint64_t operator()(const T &value) const {
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+            return mix(static_cast<uint64_t>(value));
+        else
+            return mix(std::hash<T>()(value));
+    }
+};
+
+// Open addressing hash map with linear probing over a single flat array.
+// Each slot has a control byte holding 7 bits of the hash, so most probes
+// compare one byte instead of the key. Insert only: there is no erase.
+template<typename K, typename V, typename Hash = FastHash, typename Equal = std::equal_to<K>>
+class FlatHashMap {
+public:
+    using value_type = std::pair<const K, V>;
+
+    template<bool Const>
+    class Iterator {
+        friend class FlatHashMap;
+        using Map = std::conditional_t<Const, const FlatHashMap, FlatHashMap>;
+
+        Iterator(Map *map, size_t index) : map(map), index(index) { skipEmpty(); }
+
+        void skipEmpty() {
+            while (index < map->capacity && map->control[index] == kEmpty)
+                index++;
+        }
+    public:
+        using reference = std::conditional_t<Const, const value_type &, value_type &>;
+        using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+
+        reference operator*() const { return *map->slot(index); }
+        pointer operator->() const { return map->slot(index); }
+
+        Iterator &operator++() {
+            index++;
+            skipEmpty();
+            return *this;
+        }
+
+        bool operator==(const Iterator &other) const { return index == other.index; }
+        bool operator!=(const Iterator &other) const { return index != other.index; }
+    private:
+        Map *map;
+        size_t index;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatHashMap() = default;
+
+    FlatHashMap(const FlatHashMap &other) {
+        reserve(other.count);
+        for (const auto &e : other)
+            tryEmplace(e.first, e.second);
+    }
+
+    FlatHashMap(FlatHashMap &&other) noexcept { swap(other); }
+
+    FlatHashMap &operator=(FlatHashMap other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~FlatHashMap() {
+        for (size_t i = 0; i < capacity; i++) {
+            if (control[i] != kEmpty)
+                slot(i)->~value_type();
+        }
+    }
+
+    void swap(FlatHashMap &other) noexcept {
+        std::swap(control, other.control);
+        std::swap(slots, other.slots);
+        std::swap(capacity, other.capacity);
+        std::swap(count, other.count);
+    }
+
+    // Inserts key with a value built from args unless already present.
+    // Returns the mapped value and whether it was inserted.
+    template<typename... Args>
+    std::pair<V *, bool> tryEmplace(const K &key, Args &&... args) {
+        if ((count + 1) * 8 > capacity * 7)
+            rehash(capacity ? capacity * 2 : 16);
+        uint64_t h = Hash()(key);
+        uint8_t tag = controlTag(h);
+        for (size_t i = h & (capacity - 1);; i = (i + 1) & (capacity - 1)) {
+            if (control[i] == kEmpty) {
+                new (slot(i)) value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                                         std::forward_as_tuple(std::forward<Args>(args)...));
+                control[i] = tag;
+                count++;
+                return {&slot(i)->second, true};
+            }
+            if (control[i] == tag && Equal()(slot(i)->first, key))
+                return {&slot(i)->second, false};
+        }
+    }
+
+    V &operator[](const K &key) {
+        return *tryEmplace(key).first;
+    }
+
+    V *find(const K &key) {
+        return const_cast<V *>(static_cast<const FlatHashMap *>(this)->find(key));
+    }
+
+    const V *find(const K &key) const {
+        if (count == 0)
+            return nullptr;
+        uint64_t h = Hash()(key);
+        uint8_t tag = controlTag(h);
+        for (size_t i = h & (capacity - 1); control[i] != kEmpty; i = (i + 1) & (capacity - 1)) {
+            if (control[i] == tag && Equal()(slot(i)->first, key))
+                return &slot(i)->second;
+        }
+        return nullptr;
+    }
+
+    void reserve(size_t n) {
+        size_t wanted = 16;
+        while (wanted * 7 < n * 8)
+            wanted *= 2;
+        if (wanted > capacity)
+            rehash(wanted);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, capacity); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, capacity); }
+
+private:
+    static constexpr uint8_t kEmpty = 0;
+
+    using Storage = std::aligned_storage_t<sizeof(value_type), alignof(value_type)>;
+
+    static uint8_t controlTag(uint64_t h) {
+        return static_cast<uint8_t>(0x80 | (h >> 57));
+    }
+
+    value_type *slot(size_t i) const {
+        return std::launder(reinterpret_cast<value_type *>(&slots[i]));
+    }
+
+    void rehash(size_t newCapacity) {
+        FlatHashMap bigger;
+        bigger.control = std::make_unique<uint8_t[]>(newCapacity);
+        bigger.slots = std::make_unique<Storage[]>(newCapacity);
+        bigger.capacity = newCapacity;
+        for (size_t i = 0; i < capacity; i++) {
+            if (control[i] == kEmpty)
+                continue;
+            uint64_t h = Hash()(slot(i)->first);
+            size_t j = h & (newCapacity - 1);
+            while (bigger.control[j] != kEmpty)
+                j = (j + 1) & (newCapacity - 1);
+            new (bigger.slot(j)) value_type(std::move(const_cast<K &>(slot(i)->first)), std::move(slot(i)->second));
+            bigger.control[j] = control[i];
+            bigger.count++;
+        }
+        swap(bigger);
+    }
+
+    std::unique_ptr<uint8_t[]> control;
+    std::unique_ptr<Storage[]> slots;
+    size_t capacity = 0;
+    size_t count = 0;
+};
+
+template<typename K, typename Hash = FastHash, typename Equal = std::equal_to<K>>
+class FlatHashSet {
+public:
+    // Returns true if key was not already in the set.
+    bool insert(const K &key) {
+        return map.tryEmplace(key).second;
+    }
+
+    bool contains(const K &key) const {
+        return map.find(key) != nullptr;
+    }
+
+    void reserve(size_t n) { map.reserve(n); }
+    size_t size() const { return map.size(); }
+    bool empty() const { return map.empty(); }
+
+private:
+    struct Empty {};
+    FlatHashMap<K, Empty, Hash, Equal> map;
+};
+
+#endif //CPPSTREAMS_FLAT_HASH_MAP_H
@@ -0,0 +1,120 @@
+#ifndef CPPSTREAMS_GENERATOR_H
+#define CPPSTREAMS_GENERATOR_H
+
+// Coroutine support needs C++20, the rest of the library only C++17.
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#define CPPSTREAMS_HAS_COROUTINES 1
+
+// Return type of coroutines co_yield-ing T values, consumed lazily as an input
+// range. Yielded values are not copied: the generator points to them until
+// it is resumed.
+template<typename T>
+class Generator {
+public:
+    struct promise_type {
+        const T *current = nullptr;
+        std::exception_ptr exception;
+
+        Generator get_return_object() {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        std::suspend_always yield_value(const T &value) noexcept {
+            current = std::addressof(value);
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() {
+            exception = std::current_exception();
+        }
+
+        // co_await is meaningless in a generator
+        template<typename U>
+        void await_transform(U &&) = delete;
+    };
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        iterator() = default;
+        explicit iterator(Generator *generator) : generator(generator) {}
+
+        reference operator*() const { return *generator->handle.promise().current; }
+        pointer operator->() const { return generator->handle.promise().current; }
+
+        iterator &operator++() {
+            if (!generator->next())
+                generator = nullptr;
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        bool operator==(const iterator &other) const { return generator == other.generator; }
+        bool operator!=(const iterator &other) const { return generator != other.generator; }
+
+    private:
+        Generator *generator = nullptr;
+    };
+
+    Generator(Generator &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+    Generator &operator=(Generator &&other) noexcept {
+        std::swap(handle, other.handle);
+        return *this;
+    }
+
+    Generator(const Generator &) = delete;
+    Generator &operator=(const Generator &) = delete;
+
+    ~Generator() {
+        if (handle)
+            handle.destroy();
+    }
+
+    // Resumes the coroutine up to its next co_yield. Returns the yielded value,
+    // or nullptr once the coroutine returned. Rethrows its exceptions.
+    const T *next() {
+        if (!handle || handle.done())
+            return nullptr;
+        handle.resume();
+        if (handle.promise().exception)
+            std::rethrow_exception(std::exchange(handle.promise().exception, nullptr));
+        return handle.done() ? nullptr : handle.promise().current;
+    }
+
+    iterator begin() {
+        return next() ? iterator(this) : iterator();
+    }
+
+    iterator end() {
+        return iterator();
+    }
+
+private:
+    explicit Generator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+#endif
+
+#endif //CPPSTREAMS_GENERATOR_H
@@ -0,0 +1,129 @@
+#ifndef CPPSTREAMS_HASH_JOIN_H
+#define CPPSTREAMS_HASH_JOIN_H
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "flat_hash_map.h"
+
+// Cursor of a build/probe hash join: the build side is read into a table
+// keyed by buildKey the first time it is called, then every probe element
+// is combined with each build row sharing its key, in probe order. The probe
+// side is streamed, never stored.
+//
+// When the build rows don't fit in kCacheBytes, they are first split by hash
+// into partitions small enough for their table to stay in cache while it is
+// built: the inserts then hit cache instead of each missing in one big table.
+// Only the build phase gains from it; probes are streamed in arrival order,
+// so each one is looked up in the table of its partition, wherever it is.
+template<typename B, typename P, typename K, typename X>
+class HashJoinCursor {
+public:
+    using BuildKey = std::function<K(const B &)>;
+    using ProbeKey = std::function<K(const P &)>;
+    // Called with nullptr as build row for the unmatched probe elements of
+    // an outer join.
+    using Combine = std::function<X(const P &, const B *)>;
+
+    // Conservative L2 size.
+    static constexpr size_t kCacheBytes = 256 * 1024;
+
+    HashJoinCursor(std::function<const B *()> build, BuildKey buildKey,
+                   std::function<const P *()> probe, ProbeKey probeKey,
+                   Combine combine, bool outer)
+        : build(std::move(build)), buildKey(std::move(buildKey)),
+          probe(std::move(probe)), probeKey(std::move(probeKey)),
+          combine(std::move(combine)), outer(outer) {}
+
+    const X *operator()() {
+        if (parts.empty())
+            start();
+        for (;;) {
+            if (row != kNone) {
+                current.emplace(combine(*probed, &matched->rows[row]));
+                row = matched->next[row];
+                return &*current;
+            }
+            probed = probe();
+            if (!probed)
+                return nullptr;
+            K key = probeKey(*probed);
+            matched = &parts[partitionOf(key)];
+            const size_t *head = matched->heads.find(key);
+            if (head) {
+                row = *head;
+            } else if (outer) {
+                current.emplace(combine(*probed, nullptr));
+                return &*current;
+            }
+        }
+    }
+
+private:
+    static constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+    struct Partition {
+        std::vector<B> rows;
+        // Rows sharing a key are chained through next, heads pointing to
+        // the first one.
+        FlatHashMap<K, size_t> heads;
+        std::vector<size_t> next;
+    };
+
+    void start() {
+        std::vector<B> rows;
+        while (const B *e = build())
+            rows.push_back(*e);
+        while ((rows.size() * sizeof(B) >> bits) > kCacheBytes)
+            bits++;
+        parts.resize(size_t(1) << bits);
+        if (bits == 0) {
+            parts[0].rows = std::move(rows);
+        } else {
+            for (auto &e : rows)
+                parts[partitionOf(buildKey(e))].rows.push_back(std::move(e));
+        }
+        for (auto &part : parts)
+            index(part);
+    }
+
+    // The tables take their slot from the low bits of the hash and their
+    // tag byte from the top ones, all rows of a partition would share the
+    // bits picking it: it comes from the hash mixed once more instead.
+    size_t partitionOf(const K &key) const {
+        return bits ? FastHash::mix(FastHash()(key)) >> (64 - bits) : 0;
+    }
+
+    void index(Partition &part) {
+        part.heads.reserve(part.rows.size());
+        part.next.assign(part.rows.size(), kNone);
+        for (size_t i = 0; i < part.rows.size(); i++) {
+            auto head = part.heads.tryEmplace(buildKey(part.rows[i]), i);
+            if (!head.second) {
+                part.next[i] = *head.first;
+                *head.first = i;
+            }
+        }
+    }
+
+    std::function<const B *()> build;
+    BuildKey buildKey;
+    std::function<const P *()> probe;
+    ProbeKey probeKey;
+    Combine combine;
+    bool outer;
+
+    // Empty until the build side has been read
+    std::vector<Partition> parts;
+    size_t bits = 0;
+
+    const P *probed = nullptr;
+    Partition *matched = nullptr;
+    size_t row = kNone;
+    std::optional<X> current;
+};
+
+#endif //CPPSTREAMS_HASH_JOIN_H
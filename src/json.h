@@ -0,0 +1,249 @@
+#ifndef CPPSTREAMS_JSON_H
+#define CPPSTREAMS_JSON_H
+
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "simd_scan.h"
+
+// Finds the structural characters of JSON text 64 bytes at a time: quotes
+// not escaped by a backslash, and braces, brackets, colons and commas outside
+// strings. Strings are the prefix XOR of the unescaped quote mask, carried
+// from a block to the next, like CsvCursor does.
+class JsonScanner {
+public:
+    JsonScanner(const char *begin, const char *end) : blocks(begin, end) {}
+
+    // Next structural character, nullptr at the end of the text
+    const char *next() {
+        while (!structurals) {
+            if (!nextBlock())
+                return nullptr;
+        }
+        const char *position = blockStart + trailingZeros(structurals);
+        structurals &= structurals - 1;
+        return position;
+    }
+
+private:
+    bool nextBlock() {
+        size_t length;
+        const char *block = blocks.next(length);
+        if (!block)
+            return false;
+        uint64_t escaped = escapedMask(matchMask(block, '\\'));
+        uint64_t quotes = matchMask(block, '"') & ~escaped;
+        uint64_t inString = prefixXor(quotes) ^ insideString;
+        insideString = uint64_t(0) - (inString >> 63);
+        uint64_t operators = matchMask(block, '{') | matchMask(block, '}') | matchMask(block, '[')
+                             | matchMask(block, ']') | matchMask(block, ':') | matchMask(block, ',');
+        structurals = (operators & ~inString) | quotes;
+        if (length < kScanBlockSize)
+            structurals &= (uint64_t(1) << length) - 1;
+        blockStart = blocks.blockStart();
+        return true;
+    }
+
+    // Characters following a backslash which is not itself escaped.
+    // Backslashes are rare, they are visited one by one.
+    uint64_t escapedMask(uint64_t backslashes) {
+        uint64_t escaped = escapeNext;
+        escapeNext = 0;
+        for (; backslashes; backslashes &= backslashes - 1) {
+            int i = trailingZeros(backslashes);
+            if (escaped >> i & 1)
+                continue;
+            if (i == 63)
+                escapeNext = 1;
+            else
+                escaped |= uint64_t(1) << (i + 1);
+        }
+        return escaped;
+    }
+
+    BlockReader blocks;
+    const char *blockStart = nullptr;
+    uint64_t structurals = 0;
+    // All ones when the previous block ended inside a string
+    uint64_t insideString = 0;
+    // Whether the first character of the next block is escaped
+    uint64_t escapeNext = 0;
+};
+
+// Raw text of a JSON value, only looked at when a field or a conversion is
+// asked for: get() scans an object up to the wanted key, skipping the other
+// values without parsing them, and conversions throw std::invalid_argument
+// when the value has another type. A missing value is empty.
+class JsonValue {
+public:
+    JsonValue() = default;
+
+    explicit JsonValue(std::string_view text) : text(trim(text)) {}
+
+    std::string_view raw() const {
+        return text;
+    }
+
+    bool exists() const {
+        return !text.empty();
+    }
+
+    explicit operator bool() const {
+        return exists();
+    }
+
+    bool isNull() const {
+        return text == "null";
+    }
+
+    // Value of key in this object, missing if it has no such key. Keys are
+    // compared as written, escapes included.
+    JsonValue get(std::string_view key) const {
+        if (text.empty() || text.front() != '{')
+            throw std::invalid_argument("JSON value is not an object: " + std::string(text));
+        JsonScanner scanner(text.data(), text.data() + text.size());
+        scanner.next();
+        for (;;) {
+            const char *keyStart = scanner.next();
+            if (keyStart && *keyStart == '}')
+                return JsonValue();
+            const char *keyEnd = keyStart && *keyStart == '"' ? scanner.next() : nullptr;
+            const char *colon = keyEnd ? scanner.next() : nullptr;
+            if (!colon || *colon != ':')
+                throw malformed();
+            // The value ends at the comma or brace closing it, strings and
+            // nested containers in between are skipped
+            const char *valueEnd;
+            int depth = 0;
+            for (;;) {
+                valueEnd = scanner.next();
+                if (!valueEnd)
+                    throw malformed();
+                char c = *valueEnd;
+                if (c == '"') {
+                    scanner.next();
+                } else if (c == '{' || c == '[') {
+                    depth++;
+                } else if (c == '}' || c == ']') {
+                    if (depth-- == 0)
+                        break;
+                } else if (c == ',' && depth == 0) {
+                    break;
+                }
+            }
+            if (std::string_view(keyStart + 1, keyEnd - keyStart - 1) == key)
+                return JsonValue(std::string_view(colon + 1, valueEnd - colon - 1));
+            if (*valueEnd == '}')
+                return JsonValue();
+        }
+    }
+
+    // Content of a string without its quotes, escape sequences left as they are
+    std::string_view asStringView() const {
+        if (text.size() < 2 || text.front() != '"' || text.back() != '"')
+            throw std::invalid_argument("JSON value is not a string: " + std::string(text));
+        return text.substr(1, text.size() - 2);
+    }
+
+    std::string asString() const {
+        std::string_view escaped = asStringView();
+        std::string result;
+        result.reserve(escaped.size());
+        for (size_t i = 0; i < escaped.size(); i++) {
+            if (escaped[i] != '\\' || i + 1 == escaped.size()) {
+                result += escaped[i];
+                continue;
+            }
+            char c = escaped[++i];
+            switch (c) {
+                case 'b': result += '\b'; break;
+                case 'f': result += '\f'; break;
+                case 'n': result += '\n'; break;
+                case 'r': result += '\r'; break;
+                case 't': result += '\t'; break;
+                case 'u': i = appendCodePoint(escaped, i + 1, result) - 1; break;
+                default: result += c; break;
+            }
+        }
+        return result;
+    }
+
+    int64_t asInt() const {
+        int64_t value;
+        if (!parseNumber(text, value))
+            throw std::invalid_argument("JSON value is not an integer: " + std::string(text));
+        return value;
+    }
+
+    double asDouble() const {
+        double value;
+        if (!parseNumber(text, value))
+            throw std::invalid_argument("JSON value is not a number: " + std::string(text));
+        return value;
+    }
+
+    bool asBool() const {
+        if (text == "true")
+            return true;
+        if (text == "false")
+            return false;
+        throw std::invalid_argument("JSON value is not a boolean: " + std::string(text));
+    }
+
+private:
+    static std::string_view trim(std::string_view text) {
+        const char *spaces = " \t\r\n";
+        size_t first = text.find_first_not_of(spaces);
+        if (first == std::string_view::npos)
+            return std::string_view();
+        return text.substr(first, text.find_last_not_of(spaces) - first + 1);
+    }
+
+    std::invalid_argument malformed() const {
+        return std::invalid_argument("malformed JSON object: " + std::string(text));
+    }
+
+    // Decodes the 4 hex digits at i (and the low surrogate following a high
+    // one) to UTF-8, returns the index following them
+    static size_t appendCodePoint(std::string_view escaped, size_t i, std::string &result) {
+        uint32_t code = hex4(escaped, i);
+        i += 4;
+        if (code >= 0xD800 && code < 0xDC00 && escaped.substr(i, 2) == "\\u") {
+            uint32_t low = hex4(escaped, i + 2);
+            if (low >= 0xDC00 && low < 0xE000) {
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                i += 6;
+            }
+        }
+        if (code < 0x80) {
+            result += static_cast<char>(code);
+        } else if (code < 0x800) {
+            result += static_cast<char>(0xC0 | code >> 6);
+            result += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            result += static_cast<char>(0xE0 | code >> 12);
+            result += static_cast<char>(0x80 | (code >> 6 & 0x3F));
+            result += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            result += static_cast<char>(0xF0 | code >> 18);
+            result += static_cast<char>(0x80 | (code >> 12 & 0x3F));
+            result += static_cast<char>(0x80 | (code >> 6 & 0x3F));
+            result += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        return i;
+    }
+
+    static uint32_t hex4(std::string_view escaped, size_t i) {
+        uint32_t code;
+        if (i + 4 > escaped.size() || std::from_chars(escaped.data() + i, escaped.data() + i + 4, code, 16).ptr != escaped.data() + i + 4)
+            throw std::invalid_argument("invalid JSON unicode escape: " + std::string(escaped));
+        return code;
+    }
+
+    std::string_view text;
+};
+
+#endif //CPPSTREAMS_JSON_H
@@ -0,0 +1,198 @@
+#ifndef CPPSTREAMS_MAPPED_FILE_H
+#define CPPSTREAMS_MAPPED_FILE_H
+
+// File sources map the file in memory, which needs POSIX mmap.
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CPPSTREAMS_HAS_MMAP 1
+
+// Read-only mapping of a whole file, unmapped on destruction. Elements read
+// from it point straight into the page cache: nothing is copied, but they
+// must not outlive the mapping. With hugePages, large files are mapped at a
+// huge page boundary and transparent huge pages are requested, which the
+// kernel honours for page cache backed mappings when it supports them.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &path, bool hugePages = false) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "cannot stat " + path);
+        }
+        length = static_cast<size_t>(info.st_size);
+        // An empty file can't be mapped, and doesn't need to
+        if (length != 0) {
+            void *address = hugePages && length >= kHugePageSize
+                ? mapHugePageAligned(fd)
+                : ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address == MAP_FAILED) {
+                int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "cannot map " + path);
+            }
+            bytes = static_cast<const char *>(address);
+        }
+        ::close(fd);
+        // Hints only: failing to apply them is harmless
+        advise(MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+        if (hugePages)
+            advise(MADV_HUGEPAGE);
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile() {
+        if (bytes)
+            ::munmap(const_cast<char *>(bytes), length);
+    }
+
+    const char *data() const {
+        return bytes;
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+    void advise(int advice) const {
+        if (bytes)
+            ::madvise(const_cast<char *>(bytes), length, advice);
+    }
+
+    // Byte range of the part-th of parts slices of the file, both bounds
+    // moved just after a newline so that every line falls in exactly one
+    // slice. Slices can be consumed concurrently.
+    std::pair<size_t, size_t> lineSlice(size_t part, size_t parts) const {
+        if (parts == 0 || part >= parts)
+            throw std::invalid_argument("line slice must be in [0, parts)");
+        return {lineBoundary(part, parts), lineBoundary(part + 1, parts)};
+    }
+
+private:
+    static constexpr size_t kHugePageSize = size_t(2) << 20;
+
+    // Reserves a huge page more address space than needed, maps the file at
+    // the first huge page boundary in it and releases the rest.
+    void *mapHugePageAligned(int fd) {
+        size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        size_t reservedLength = length + kHugePageSize;
+        void *reserved = ::mmap(nullptr, reservedLength, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (reserved == MAP_FAILED)
+            return ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        uintptr_t start = reinterpret_cast<uintptr_t>(reserved);
+        uintptr_t aligned = (start + kHugePageSize - 1) & ~(kHugePageSize - 1);
+        void *address = ::mmap(reinterpret_cast<void *>(aligned), length, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (address == MAP_FAILED) {
+            ::munmap(reserved, reservedLength);
+            return MAP_FAILED;
+        }
+        uintptr_t mappedEnd = aligned + (length + pageSize - 1) / pageSize * pageSize;
+        uintptr_t reservedEnd = start + (reservedLength + pageSize - 1) / pageSize * pageSize;
+        if (aligned > start)
+            ::munmap(reserved, aligned - start);
+        if (reservedEnd > mappedEnd)
+            ::munmap(reinterpret_cast<void *>(mappedEnd), reservedEnd - mappedEnd);
+        return address;
+    }
+
+    size_t lineBoundary(size_t part, size_t parts) const {
+        if (part == 0)
+            return 0;
+        if (part == parts)
+            return length;
+        // Split point in the middle of a line: the line belongs to the slice
+        // it starts in. Computed in long double to avoid overflowing part * length.
+        size_t from = static_cast<size_t>(static_cast<long double>(length) * part / parts);
+        if (from == 0)
+            return 0;
+        const void *newline = std::memchr(bytes + from - 1, '\n', length - from + 1);
+        return newline ? static_cast<const char *>(newline) - bytes + 1 : length;
+    }
+
+    const char *bytes = nullptr;
+    size_t length = 0;
+};
+
+// Lines of [begin, end) as views, without their "\n" or "\r\n" terminator. The
+// newlines are found with memchr, which the C library vectorizes.
+class LineCursor {
+public:
+    LineCursor(const char *begin, const char *end) : position(begin), end(end) {}
+
+    const std::string_view *operator()() {
+        if (position == end)
+            return nullptr;
+        const char *newline = static_cast<const char *>(std::memchr(position, '\n', end - position));
+        const char *lineEnd = newline ? newline : end;
+        size_t length = lineEnd - position;
+        if (length && position[length - 1] == '\r')
+            length--;
+        current = std::string_view(position, length);
+        position = newline ? newline + 1 : end;
+        return &current;
+    }
+
+private:
+    const char *position;
+    const char *end;
+    std::string_view current;
+};
+
+// Fixed size records of [begin, end), a trailing incomplete one being
+// ignored. Records suitably aligned for T are read in place; otherwise (e.g.
+// after an odd sized header) each one is copied with memcpy into a buffer,
+// instead of being read through a misaligned pointer.
+template<typename T>
+class RecordCursor {
+    static_assert(std::is_trivially_copyable_v<T>, "records must be trivially copyable");
+
+public:
+    RecordCursor(const char *begin, const char *end)
+        : position(begin), end(begin + (end - begin) / sizeof(T) * sizeof(T)),
+          aligned(reinterpret_cast<uintptr_t>(begin) % alignof(T) == 0) {}
+
+    const T *operator()() {
+        if (position == end)
+            return nullptr;
+        const char *record = position;
+        position += sizeof(T);
+        if (aligned)
+            return reinterpret_cast<const T *>(record);
+        std::memcpy(buffer, record, sizeof(T));
+        return std::launder(reinterpret_cast<const T *>(buffer));
+    }
+
+private:
+    const char *position;
+    const char *end;
+    bool aligned;
+    alignas(T) unsigned char buffer[sizeof(T)];
+};
+
+#endif
+
+#endif //CPPSTREAMS_MAPPED_FILE_H
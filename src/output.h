@@ -0,0 +1,127 @@
+#ifndef CPPSTREAMS_OUTPUT_H
+#define CPPSTREAMS_OUTPUT_H
+
+// File sinks write to file descriptors with writev, which needs POSIX.
+#if __has_include(<sys/uio.h>) && __has_include(<unistd.h>)
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define CPPSTREAMS_HAS_WRITEV 1
+
+// Formats values as text into fixed size chunks, and hands all the filled
+// chunks to the kernel with a single writev once there are enough of them,
+// instead of a write per value. Numbers are formatted with to_chars, strings
+// copied as they are, and other types go through their operator<<.
+class OutputBuffer {
+public:
+    static constexpr size_t kChunkSize = 64 * 1024;
+    static constexpr size_t kChunksPerFlush = 16;
+
+    explicit OutputBuffer(int fd) : fd(fd) {}
+
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+    template<typename V>
+    void append(const V &value) {
+        if constexpr (std::is_same_v<V, bool>) {
+            append(std::string_view(value ? "true" : "false"));
+        } else if constexpr (std::is_same_v<V, char>) {
+            append(std::string_view(&value, 1));
+        } else if constexpr (std::is_arithmetic_v<V>) {
+            // Enough for any integer and the shortest round trip of a double
+            char text[64];
+            append(std::string_view(text, formatNumber(text, text + sizeof(text), value) - text));
+        } else if constexpr (std::is_convertible_v<const V &, std::string_view>) {
+            append(std::string_view(value));
+        } else {
+            std::ostringstream text;
+            text << value;
+            append(std::string_view(text.str()));
+        }
+    }
+
+    void append(std::string_view text) {
+        while (!text.empty()) {
+            if (chunks.empty() || used == kChunkSize) {
+                if (chunks.size() == kChunksPerFlush)
+                    flush();
+                if (chunks.size() == filled.size())
+                    filled.push_back(std::make_unique<char[]>(kChunkSize));
+                chunks.push_back(filled[chunks.size()].get());
+                used = 0;
+            }
+            size_t n = std::min(text.size(), kChunkSize - used);
+            std::memcpy(chunks.back() + used, text.data(), n);
+            used += n;
+            text.remove_prefix(n);
+        }
+    }
+
+    // Writes everything appended so far, resuming after partial writes.
+    // Throws std::system_error when the write fails. Text still buffered
+    // when the OutputBuffer is destroyed is lost.
+    void flush() {
+        pending.clear();
+        for (size_t i = 0; i < chunks.size(); i++)
+            pending.push_back({chunks[i], i + 1 == chunks.size() ? used : kChunkSize});
+        size_t first = 0;
+        while (first < pending.size()) {
+            int count = static_cast<int>(std::min<size_t>(pending.size() - first, IOV_MAX));
+            ssize_t written = ::writev(fd, pending.data() + first, count);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category(), "cannot write output");
+            }
+            auto n = static_cast<size_t>(written);
+            for (; first < pending.size() && n >= pending[first].iov_len; first++)
+                n -= pending[first].iov_len;
+            if (n) {
+                pending[first].iov_base = static_cast<char *>(pending[first].iov_base) + n;
+                pending[first].iov_len -= n;
+            }
+        }
+        chunks.clear();
+        used = 0;
+    }
+
+private:
+    template<typename V>
+    static char *formatNumber(char *first, char *last, V value) {
+#if !defined(__cpp_lib_to_chars) || __cpp_lib_to_chars < 201611L
+        if constexpr (std::is_floating_point_v<V>)
+            return first + std::snprintf(first, last - first, "%.17g", static_cast<double>(value));
+        else
+#endif
+            return std::to_chars(first, last, value).ptr;
+    }
+
+    int fd;
+    // Chunks holding appended text, the last one used bytes
+    std::vector<char *> chunks;
+    size_t used = 0;
+    // Chunks allocated so far, reused from a flush to the next
+    std::vector<std::unique_ptr<char[]>> filled;
+    std::vector<iovec> pending;
+};
+
+#endif
+
+#endif //CPPSTREAMS_OUTPUT_H
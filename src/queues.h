@@ -0,0 +1,332 @@
+#ifndef CPPSTREAMS_QUEUES_H
+#define CPPSTREAMS_QUEUES_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+// Keeps the indices written by different threads on separate cache lines
+constexpr size_t kCacheLineSize = 64;
+
+// Waiting strategy for the queues: spins a little, then yields, then sleeps
+// for growing (bounded) periods so that an idle side doesn't burn a core.
+class Backoff {
+public:
+    void wait() {
+        if (step < 16) {
+            // busy spin
+        } else if (step < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(std::min<size_t>(step - 63, 100)));
+        }
+        step++;
+    }
+
+    void reset() {
+        step = 0;
+    }
+
+private:
+    size_t step = 0;
+};
+
+// Bounded lock-free single producer / single consumer ring buffer. Capacity
+// is rounded up to a power of two. tryPush must only be called from one
+// thread and tryPop from one (other) thread.
+template<typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+        slots = std::make_unique<std::optional<T>[]>(size);
+        mask = size - 1;
+    }
+
+    bool tryPush(T &&value) {
+        size_t tail = this->tail.load(std::memory_order_relaxed);
+        if (tail - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (tail - cachedHead > mask)
+                return false;
+        }
+        slots[tail & mask].emplace(std::move(value));
+        this->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> tryPop() {
+        size_t head = this->head.load(std::memory_order_relaxed);
+        if (head == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (head == cachedTail)
+                return std::nullopt;
+        }
+        std::optional<T> value = std::move(slots[head & mask]);
+        slots[head & mask].reset();
+        this->head.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+private:
+    std::unique_ptr<std::optional<T>[]> slots;
+    size_t mask;
+    // Consumer side
+    alignas(kCacheLineSize) std::atomic<size_t> head{0};
+    size_t cachedTail = 0;
+    // Producer side
+    alignas(kCacheLineSize) std::atomic<size_t> tail{0};
+    size_t cachedHead = 0;
+};
+
+// Bounded multi producer / multi consumer channel. The queue itself is lock
+// free (Vyukov's bounded MPMC ring: each cell has a sequence number telling
+// whether it is ready to be written or read for a given lap). The mutex and
+// condition variables are only touched by threads that have to wait, on a
+// full channel for producers (backpressure) or an empty one for consumers.
+// After close(), push fails and pop drains what is left: every element for
+// which push returned true is popped once.
+template<typename T>
+class Channel {
+public:
+    explicit Channel(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+        cells = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; i++)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        mask = size - 1;
+    }
+
+    Channel(const Channel &) = delete;
+    Channel &operator=(const Channel &) = delete;
+
+    // Waits while the channel is full. Returns false, dropping value, once
+    // the channel is closed. A push already running when close() is called
+    // may still deliver its element, which consumers then pop before the end.
+    bool push(T value) {
+        pushing.fetch_add(1);
+        bool pushed = false;
+        try {
+            while (!pushed && !closed()) {
+                pushed = tryPush(value);
+                if (!pushed)
+                    wait(waitingProducers, notFull, [&] { return pushed = tryPush(value); });
+            }
+        } catch (...) {
+            pushing.fetch_sub(1);
+            throw;
+        }
+        pushing.fetch_sub(1);
+        if (pushed)
+            wake(waitingConsumers, notEmpty);
+        return pushed;
+    }
+
+    // Waits while the channel is empty and open. Returns nullopt once it is
+    // closed, the pushes running at that time have returned, and it is
+    // drained.
+    std::optional<T> pop() {
+        for (;;) {
+            std::optional<T> value = tryPop();
+            if (!value) {
+                if (closed()) {
+                    // A push seeing the channel open was counted before close
+                    // (both are sequentially consistent): wait for it to land
+                    Backoff backoff;
+                    while (pushing.load() != 0)
+                        backoff.wait();
+                    if (!(value = tryPop()))
+                        return value;
+                } else {
+                    wait(waitingConsumers, notEmpty, [&] { return bool(value = tryPop()); });
+                    if (!value)
+                        continue;
+                }
+            }
+            wake(waitingProducers, notFull);
+            return value;
+        }
+    }
+
+    void close() {
+        isClosed.store(true);
+        std::lock_guard<std::mutex> lock(mutex);
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+    bool closed() const {
+        return isClosed.load();
+    }
+
+    // On success value is moved from
+    bool tryPush(T &value) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value.emplace(std::move(value));
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::optional<T> tryPop() {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    std::optional<T> value = std::move(cell.value);
+                    cell.value.reset();
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return value;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        std::optional<T> value;
+    };
+
+    // Registers as waiter before retrying under the lock, and the other side
+    // checks for waiters after its operation: either the retry succeeds or
+    // the other side sees the waiter and notifies it.
+    template<typename Retry>
+    void wait(std::atomic<size_t> &waiters, std::condition_variable &condition, Retry retry) {
+        std::unique_lock<std::mutex> lock(mutex);
+        waiters.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!retry() && !closed())
+            condition.wait(lock);
+        waiters.fetch_sub(1);
+    }
+
+    void wake(std::atomic<size_t> &waiters, std::condition_variable &condition) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load() == 0)
+            return;
+        std::lock_guard<std::mutex> lock(mutex);
+        condition.notify_one();
+    }
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(kCacheLineSize) std::atomic<size_t> enqueuePos{0};
+    alignas(kCacheLineSize) std::atomic<size_t> dequeuePos{0};
+    alignas(kCacheLineSize) std::atomic<bool> isClosed{false};
+    // push calls in progress
+    std::atomic<size_t> pushing{0};
+    std::atomic<size_t> waitingProducers{0};
+    std::atomic<size_t> waitingConsumers{0};
+    std::mutex mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+};
+
+// Cursor running the cursor returned by open on a thread of its own, which
+// hands the elements over through an SpscQueue: the upstream work overlaps
+// with the one of the caller. Exceptions thrown upstream are rethrown by the
+// caller. Once the last copy of the cursor is destroyed the producer thread
+// is stopped before its next upstream element and joined: destruction waits
+// for the upstream call in progress to return.
+template<typename T>
+class AsyncCursor {
+public:
+    AsyncCursor(std::function<std::function<const T *()>()> open, size_t capacity)
+        : state(std::make_shared<State>(capacity)) {
+        State *s = state.get();
+        s->producer = std::thread([s, open = std::move(open)] {
+            try {
+                auto cursor = open();
+                Backoff backoff;
+                while (!s->cancelled.load(std::memory_order_relaxed)) {
+                    const T *e = cursor();
+                    if (!e)
+                        break;
+                    T value = *e;
+                    while (!s->queue.tryPush(std::move(value))) {
+                        if (s->cancelled.load(std::memory_order_relaxed))
+                            return;
+                        backoff.wait();
+                    }
+                    backoff.reset();
+                }
+            } catch (...) {
+                s->error = std::current_exception();
+            }
+            s->done.store(true, std::memory_order_release);
+        });
+    }
+
+    const T *operator()() {
+        Backoff backoff;
+        for (;;) {
+            if ((current = state->queue.tryPop()))
+                return &*current;
+            if (state->done.load(std::memory_order_acquire)) {
+                // What was pushed before done was set is visible by now
+                if ((current = state->queue.tryPop()))
+                    return &*current;
+                if (state->error)
+                    std::rethrow_exception(std::exchange(state->error, nullptr));
+                return nullptr;
+            }
+            backoff.wait();
+        }
+    }
+
+private:
+    struct State {
+        explicit State(size_t capacity) : queue(capacity) {}
+
+        ~State() {
+            cancelled.store(true, std::memory_order_relaxed);
+            if (producer.joinable())
+                producer.join();
+        }
+
+        SpscQueue<T> queue;
+        std::atomic<bool> done{false};
+        std::atomic<bool> cancelled{false};
+        std::exception_ptr error;
+        std::thread producer;
+    };
+
+    std::shared_ptr<State> state;
+    std::optional<T> current;
+};
+
+#endif //CPPSTREAMS_QUEUES_H
@@ -0,0 +1,125 @@
+#ifndef CPPSTREAMS_SIMD_SCAN_H
+#define CPPSTREAMS_SIMD_SCAN_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CPPSTREAMS_HAS_SSE2 1
+#endif
+
+// Text scanning 64 bytes at a time: each character class of a block is
+// turned into a 64 bit mask (bit i for byte i), so that parsers find their
+// structural characters with bit operations instead of testing every byte.
+
+constexpr size_t kScanBlockSize = 64;
+
+// Bit i set when block[i] == c
+inline uint64_t matchMask(const char *block, char c) {
+#ifdef CPPSTREAMS_HAS_SSE2
+    const __m128i needle = _mm_set1_epi8(c);
+    uint64_t mask = 0;
+    for (size_t i = 0; i < kScanBlockSize; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+        auto bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+        mask |= uint64_t(bits) << i;
+    }
+    return mask;
+#else
+    uint64_t mask = 0;
+    for (size_t i = 0; i < kScanBlockSize; i++)
+        mask |= uint64_t(block[i] == c) << i;
+    return mask;
+#endif
+}
+
+// Bit i set when an odd number of bits are set in mask up to bit i: applied
+// to quote positions, the bytes inside quoted strings (opening quote
+// included, closing one excluded).
+inline uint64_t prefixXor(uint64_t mask) {
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+}
+
+inline int trailingZeros(uint64_t mask) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(mask);
+#else
+    int n = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+// Iterates over blocks of [begin, end), the last incomplete one being copied
+// into a buffer padded with fill (a byte none of the masks look for).
+class BlockReader {
+public:
+    BlockReader(const char *begin, const char *end, char fill = ' ') : position(begin), end(end), fill(fill) {}
+
+    // Next block and its number of meaningful bytes, nullptr at the end
+    const char *next(size_t &length) {
+        if (position == end)
+            return nullptr;
+        const char *block = position;
+        length = static_cast<size_t>(end - position);
+        if (length >= kScanBlockSize) {
+            length = kScanBlockSize;
+        } else {
+            for (size_t i = 0; i < kScanBlockSize; i++)
+                padded[i] = i < length ? position[i] : fill;
+            block = padded;
+        }
+        start = position;
+        position += length;
+        return block;
+    }
+
+    // Address in the input of the block last returned by next
+    const char *blockStart() const {
+        return start;
+    }
+
+private:
+    const char *position;
+    const char *end;
+    char fill;
+    const char *start = nullptr;
+    char padded[kScanBlockSize];
+};
+
+// Parses the whole of text as a number, returns false when it isn't one
+template<typename V>
+bool parseNumber(std::string_view text, V &value) {
+    static_assert(std::is_arithmetic_v<V> && !std::is_same_v<V, bool>, "only numbers are parsed");
+#if !defined(__cpp_lib_to_chars) || __cpp_lib_to_chars < 201611L
+    if constexpr (std::is_floating_point_v<V>) {
+        // No floating point from_chars in this standard library
+        std::string copy(text);
+        char *end;
+        value = static_cast<V>(std::strtold(copy.c_str(), &end));
+        return !copy.empty() && end == copy.c_str() + copy.size();
+    } else
+#endif
+    {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+}
+
+#endif //CPPSTREAMS_SIMD_SCAN_H
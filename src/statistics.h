@@ -0,0 +1,116 @@
+#ifndef CPPSTREAMS_STATISTICS_H
+#define CPPSTREAMS_STATISTICS_H
+
+#include <cstddef>
+#include <type_traits>
+
+// Count, sum, min, max, mean and variance of arithmetic values computed in a
+// single pass. The variance is maintained with Welford's update, and partial
+// results (of chunks processed separately, e.g. by different threads) are
+// combined with merge().
+template<typename T>
+struct SummaryStatistics {
+    static_assert(std::is_arithmetic_v<T>, "SummaryStatistics needs arithmetic values");
+
+    using Sum = std::conditional_t<std::is_integral_v<T>, long long, double>;
+
+    size_t count = 0;
+    Sum sum = 0;
+    // Only meaningful when count > 0
+    T min = T();
+    T max = T();
+    double mean = 0.0;
+    // Sum of squared differences to the mean
+    double m2 = 0.0;
+
+    void accept(T value) {
+        if (count == 0) {
+            min = max = value;
+        } else {
+            min = value < min ? value : min;
+            max = max < value ? value : max;
+        }
+        count++;
+        sum += value;
+        double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+    }
+
+    // Summarizes a contiguous block with two passes over it (sum, then
+    // squared differences to its mean) before merging it. The loops keep
+    // four independent accumulators so that they can be vectorized without
+    // reassociating floating point operations.
+    void acceptBlock(const T *values, size_t n) {
+        if (n == 0)
+            return;
+        SummaryStatistics block;
+        Sum sums[4] = {0, 0, 0, 0};
+        T lows[4] = {values[0], values[0], values[0], values[0]};
+        T highs[4] = {values[0], values[0], values[0], values[0]};
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            for (size_t j = 0; j < 4; j++) {
+                sums[j] += values[i + j];
+                lows[j] = values[i + j] < lows[j] ? values[i + j] : lows[j];
+                highs[j] = highs[j] < values[i + j] ? values[i + j] : highs[j];
+            }
+        }
+        for (; i < n; i++) {
+            sums[0] += values[i];
+            lows[0] = values[i] < lows[0] ? values[i] : lows[0];
+            highs[0] = highs[0] < values[i] ? values[i] : highs[0];
+        }
+        block.count = n;
+        block.sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+        block.min = lows[0];
+        block.max = highs[0];
+        for (size_t j = 1; j < 4; j++) {
+            block.min = lows[j] < block.min ? lows[j] : block.min;
+            block.max = block.max < highs[j] ? highs[j] : block.max;
+        }
+        block.mean = static_cast<double>(block.sum) / n;
+        double squares[4] = {0.0, 0.0, 0.0, 0.0};
+        for (i = 0; i + 4 <= n; i += 4) {
+            for (size_t j = 0; j < 4; j++) {
+                double delta = values[i + j] - block.mean;
+                squares[j] += delta * delta;
+            }
+        }
+        for (; i < n; i++) {
+            double delta = values[i] - block.mean;
+            squares[0] += delta * delta;
+        }
+        block.m2 = (squares[0] + squares[1]) + (squares[2] + squares[3]);
+        merge(block);
+    }
+
+    // Chan et al. pairwise combination of two partial results
+    void merge(const SummaryStatistics &other) {
+        if (other.count == 0)
+            return;
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+        size_t total = count + other.count;
+        double delta = other.mean - mean;
+        mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * count / total * other.count;
+        min = other.min < min ? other.min : min;
+        max = max < other.max ? other.max : max;
+        sum += other.sum;
+        count = total;
+    }
+
+    // Population variance
+    double variance() const {
+        return count ? m2 / count : 0.0;
+    }
+
+    double sampleVariance() const {
+        return count > 1 ? m2 / (count - 1) : 0.0;
+    }
+};
+
+#endif //CPPSTREAMS_STATISTICS_H
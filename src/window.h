@@ -0,0 +1,160 @@
+#ifndef CPPSTREAMS_WINDOW_H
+#define CPPSTREAMS_WINDOW_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <vector>
+
+// Window states used by WindowCursor. Each one supports appending an element
+// to the window, dropping its oldest one and reading the aggregate of its
+// current content, all in amortized O(1).
+
+// Any associative op with an identity, using two stacks: elements are pushed
+// on the back stack, and moved to the front stack as suffix aggregates when it
+// runs empty, so that the window aggregate is op(front top, back aggregate).
+template<typename R, typename Op>
+class SlidingMonoid {
+public:
+    SlidingMonoid(R identity, Op op) : identity(identity), op(op), backAggregate(identity) {}
+
+    template<typename T>
+    void push(const T &e) {
+        back.push_back(R(e));
+        backAggregate = op(backAggregate, back.back());
+    }
+
+    void pop() {
+        if (front.empty()) {
+            R aggregate = identity;
+            for (auto it = back.rbegin(); it != back.rend(); ++it) {
+                aggregate = op(*it, aggregate);
+                front.push_back(aggregate);
+            }
+            back.clear();
+            backAggregate = identity;
+        }
+        front.pop_back();
+    }
+
+    R value() const {
+        return front.empty() ? backAggregate : op(front.back(), backAggregate);
+    }
+
+    void clear() {
+        front.clear();
+        back.clear();
+        backAggregate = identity;
+    }
+
+private:
+    R identity;
+    Op op;
+    std::vector<R> front;
+    std::vector<R> back;
+    R backAggregate;
+};
+
+// Exact running sum for integral types: add on push, subtract on pop.
+template<typename T>
+class SlidingSum {
+public:
+    void push(const T &e) {
+        elements.push_back(e);
+        sum += e;
+    }
+
+    void pop() {
+        sum -= elements.front();
+        elements.pop_front();
+    }
+
+    T value() const { return sum; }
+
+    void clear() {
+        elements.clear();
+        sum = T();
+    }
+
+private:
+    std::deque<T> elements;
+    T sum = T();
+};
+
+// Min (Compare = std::less) or max (std::greater) with a monotonic deque:
+// an element is dropped as soon as a newer one compares better, so the
+// front always holds the window extremum.
+template<typename T, typename Compare>
+class SlidingExtremum {
+public:
+    void push(const T &e) {
+        while (!candidates.empty() && !Compare()(candidates.back().second, e))
+            candidates.pop_back();
+        candidates.emplace_back(pushed++, e);
+    }
+
+    void pop() {
+        if (candidates.front().first == popped)
+            candidates.pop_front();
+        popped++;
+    }
+
+    T value() const { return candidates.front().second; }
+
+    void clear() {
+        candidates.clear();
+        popped = pushed;
+    }
+
+private:
+    std::deque<std::pair<size_t, T>> candidates;
+    size_t pushed = 0;
+    size_t popped = 0;
+};
+
+// Emits the aggregate of each window of size elements, a new window starting
+// every step elements: tumbling windows when step == size, sliding ones when
+// smaller, and with the elements in between skipped when larger. A last
+// incomplete window is not emitted.
+template<typename T, typename R, typename State>
+class WindowCursor {
+public:
+    WindowCursor(std::function<const T *()> upstream, size_t size, size_t step, State state)
+        : upstream(std::move(upstream)), size(size), step(step), state(std::move(state)) {}
+
+    const R *operator()() {
+        while (const T *e = upstream()) {
+            if (skip) {
+                skip--;
+                continue;
+            }
+            state.push(*e);
+            if (++filled < size)
+                continue;
+            current.emplace(state.value());
+            if (step >= size) {
+                state.clear();
+                filled = 0;
+                skip = step - size;
+            } else {
+                for (size_t i = 0; i < step; i++)
+                    state.pop();
+                filled -= step;
+            }
+            return &*current;
+        }
+        return nullptr;
+    }
+
+private:
+    std::function<const T *()> upstream;
+    size_t size;
+    size_t step;
+    State state;
+    size_t filled = 0;
+    size_t skip = 0;
+    std::optional<R> current;
+};
+
+#endif //CPPSTREAMS_WINDOW_H
@@ -0,0 +1,102 @@
+#include <cppstreams.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+using ::testing::Test;
+using namespace std;
+
+
+class StreamsFromChannelTests : public Test {
+
+protected:
+
+    StreamsFromChannelTests() {}
+
+    virtual ~StreamsFromChannelTests() {}
+
+};
+
+TEST_F(StreamsFromChannelTests, StreamsFromChannelTests_ManyProducersOneStream_Test) {
+    Channel<long> channel(64);
+    vector<thread> producers;
+    for (long p = 0; p < 4; p++) {
+        producers.emplace_back([&channel, p] {
+            for (long i = 0; i < 10000; i++)
+                channel.push(p * 10000 + i);
+        });
+    }
+    thread closer([&] {
+        for (auto &producer : producers)
+            producer.join();
+        channel.close();
+    });
+
+    auto stats = Stream<long, std::vector>::makeStream(channel).summaryStatistics();
+    closer.join();
+
+    ASSERT_EQ(stats.count, 40000UL);
+    ASSERT_EQ(stats.sum, 39999L * 40000 / 2);
+    ASSERT_FALSE(channel.pop());
+}
+
+TEST_F(StreamsFromChannelTests, StreamsFromChannelTests_StreamSinkWithBackpressure_Test) {
+    Channel<int> channel(4);
+    vector<int> received;
+    thread consumer([&] {
+        while (auto value = channel.pop())
+            received.push_back(*value);
+    });
+
+    size_t pushed = Stream<int, std::vector>::range(0, 1000)
+        .filter([](const int &iValue) { return iValue % 2 == 0; })
+        .pushTo(channel);
+    channel.close();
+    consumer.join();
+
+    ASSERT_EQ(pushed, 500UL);
+    ASSERT_EQ(received.size(), 500UL);
+    ASSERT_EQ(received.back(), 998);
+    ASSERT_FALSE(channel.push(1));
+}
+
+TEST_F(StreamsFromChannelTests, StreamsFromChannelTests_SeveralConsumingStreams_Test) {
+    Channel<int> channel(16);
+    thread producer([&] {
+        Stream<int, std::vector>::range(1, 5001).pushTo(channel);
+        channel.close();
+    });
+    long sums[2] = {0, 0};
+    thread other([&] { sums[1] = Stream<int, std::vector>::makeStream(channel).reduce(0L, std::plus<long>()); });
+    sums[0] = Stream<int, std::vector>::makeStream(channel).reduce(0L, std::plus<long>());
+    other.join();
+    producer.join();
+
+    ASSERT_EQ(sums[0] + sums[1], 5000L * 5001 / 2);
+}
+
+TEST_F(StreamsFromChannelTests, StreamsFromChannelTests_CloseWhilePushingLosesNothing_Test) {
+    // The race with close() is narrow: many short rounds
+    for (int round = 0; round < 2000; round++) {
+        Channel<int> channel(2);
+        atomic<long> accepted{0};
+        atomic<long> received{0};
+        vector<thread> threads;
+        for (int p = 0; p < 4; p++) {
+            threads.emplace_back([&] {
+                while (channel.push(1))
+                    accepted++;
+            });
+        }
+        for (int c = 0; c < 2; c++)
+            threads.emplace_back([&] { received += Stream<int, std::vector>::makeStream(channel).count(); });
+        this_thread::sleep_for(chrono::microseconds(round % 20));
+        channel.close();
+        for (auto &t : threads)
+            t.join();
+
+        ASSERT_EQ(received.load(), accepted.load());
+    }
+}
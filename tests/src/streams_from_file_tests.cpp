@@ -0,0 +1,310 @@
+#include <cppstreams.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <system_error>
+#include <vector>
+
+using ::testing::Test;
+using namespace std;
+
+struct Tick {
+    long time;
+    double price;
+    int volume;
+    int venue;
+    long sequence;
+};
+
+
+class StreamsFromFileTests : public Test {
+
+protected:
+
+    StreamsFromFileTests() : path((std::filesystem::temp_directory_path() / "cppstreams_file_tests.txt").string()) {}
+
+    virtual ~StreamsFromFileTests() {
+        std::remove(path.c_str());
+    }
+
+    void write(const string &content) {
+        ofstream(path, ios::binary) << content;
+    }
+
+    string read() {
+        ifstream file(path, ios::binary);
+        stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    void writeTicks(size_t count, const string &header = "") {
+        ofstream file(path, ios::binary);
+        file << header;
+        for (size_t i = 0; i < count; i++) {
+            Tick tick = {long(i), 100.0 + i, int(i % 7), 1, long(i) * 2};
+            file.write(reinterpret_cast<const char *>(&tick), sizeof(tick));
+        }
+    }
+
+    string path;
+};
+
+#ifdef CPPSTREAMS_HAS_MMAP
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_Lines_Test) {
+    write("first\nsecond\r\n\nlast");
+    auto oStream = Stream<string_view, std::vector>::lines(path);
+
+    vector<string_view> result = oStream.collect();
+
+    vector<string_view> expected = {"first", "second", "", "last"};
+    ASSERT_EQ(result, expected);
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_LinesFilterMap_Test) {
+    write("1\n22\n333\n4444\n");
+
+    size_t result = Stream<string_view, std::vector>::lines(path)
+        .filter([](const string_view &line) { return line.size() % 2 == 0; })
+        .map([](const string_view &line) { return line.size(); })
+        .sum();
+
+    ASSERT_EQ(result, 6UL);
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_EmptyFile_Test) {
+    write("");
+
+    size_t result = Stream<string_view, std::vector>::lines(path).count();
+
+    ASSERT_EQ(result, 0UL);
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_LineSlices_Test) {
+    string content;
+    for (int i = 0; i < 1000; i++)
+        content += to_string(i) + "\n";
+    write(content);
+
+    for (size_t parts : {1, 2, 3, 7, 5000}) {
+        vector<int> result;
+        for (size_t part = 0; part < parts; part++) {
+            auto slice = Stream<string_view, std::vector>::lines(path, part, parts)
+                .map([](const string_view &line) { return stoi(string(line)); })
+                .collect();
+            result.insert(result.end(), slice.begin(), slice.end());
+        }
+        ASSERT_EQ(result.size(), 1000UL);
+        for (int i = 0; i < 1000; i++)
+            ASSERT_EQ(result[i], i);
+    }
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_MissingFile_Test) {
+    string missing = path + ".missing";
+
+    ASSERT_THROW((Stream<string_view, std::vector>::lines(missing)), std::system_error);
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_Records_Test) {
+    writeTicks(1000);
+
+    auto ticks = Stream<Tick, std::vector>::records(path).collect();
+
+    ASSERT_EQ(ticks.size(), 1000UL);
+    ASSERT_EQ(ticks[999].time, 999);
+    ASSERT_EQ(ticks[999].price, 1099.0);
+    ASSERT_EQ(ticks[999].sequence, 1998);
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_RecordsAfterUnalignedHeader_Test) {
+    writeTicks(100, "HDR");
+
+    long volume = Stream<Tick, std::vector>::records(path, 3)
+        .map([](const Tick &tick) { return long(tick.volume); })
+        .sum();
+    size_t count = Stream<Tick, std::vector>::records(path, 3).count();
+
+    ASSERT_EQ(count, 100UL);
+    ASSERT_EQ(volume, 295L);
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_RecordsIgnoreIncompleteTrailingRecord_Test) {
+    writeTicks(10);
+    ofstream(path, ios::binary | ios::app) << "xyz";
+
+    size_t count = Stream<Tick, std::vector>::records(path).count();
+    size_t beyond = Stream<Tick, std::vector>::records(path, 1 << 20).count();
+
+    ASSERT_EQ(count, 10UL);
+    ASSERT_EQ(beyond, 0UL);
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_RecordsLargeFile_Test) {
+    // Above a huge page, mapped at a huge page boundary
+    writeTicks(200000);
+
+    auto last = Stream<Tick, std::vector>::records(path).skip(199999).findFirst([](const Tick &) { return true; });
+
+    ASSERT_TRUE(last);
+    ASSERT_EQ(last->sequence, 399998);
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_Csv_Test) {
+    write("id,name,comment\r\n"
+          "1,\"Doe, John\",\"said \"\"hi\"\"\"\r\n"
+          "\r\n"
+          "2,Smith,\"two\nlines\"\n"
+          "3,,");
+
+    auto oStream = Stream<CsvRow, std::vector>::csv(path);
+
+    auto rows = oStream.skip(1).collect();
+
+    ASSERT_EQ(rows.size(), 3UL);
+    ASSERT_EQ(rows[0].size(), 3UL);
+    ASSERT_EQ(rows[0][1], "Doe, John");
+    ASSERT_EQ(rows[0][2], "said \"\"hi\"\"");
+    ASSERT_EQ(rows[0].unescaped(2), "said \"hi\"");
+    ASSERT_EQ(rows[1][2], "two\nlines");
+    ASSERT_EQ(rows[2].size(), 3UL);
+    ASSERT_EQ(rows[2][1], "");
+    ASSERT_EQ(rows[2][2], "");
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_CsvTypedColumns_Test) {
+    string content = "symbol\tprice\tvolume\n";
+    for (int i = 0; i < 1000; i++)
+        content += "\"SYM" + to_string(i) + "\"\t" + to_string(i) + ".5\t" + to_string(i % 10) + "\n";
+    write(content);
+
+    double result = Stream<CsvRow, std::vector>::csv(path, '\t')
+        .skip(1)
+        .filter([](const CsvRow &row) { return row.as<int>(2) == 9; })
+        .map([](const CsvRow &row) { return row.as<double>(1); })
+        .sum();
+    size_t symbols = Stream<CsvRow, std::vector>::csv(path, '\t')
+        .filter([](const CsvRow &row) { return row[0].substr(0, 3) == "SYM"; })
+        .count();
+
+    ASSERT_EQ(result, 50450.0);
+    ASSERT_EQ(symbols, 1000UL);
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_CsvQuotedFieldsAcrossBlocks_Test) {
+    string longField(150, 'x');
+    longField[70] = ',';
+    longField[130] = '\n';
+    write("\"" + longField + "\",end\n\"" + longField + "\"");
+    auto oStream = Stream<CsvRow, std::vector>::csv(path);
+
+    auto rows = oStream.collect();
+
+    ASSERT_EQ(rows.size(), 2UL);
+    ASSERT_EQ(rows[0].size(), 2UL);
+    ASSERT_EQ(rows[0][0], longField);
+    ASSERT_EQ(rows[0][1], "end");
+    ASSERT_EQ(rows[1].size(), 1UL);
+    ASSERT_EQ(rows[1][0], longField);
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_CsvNotANumber_Test) {
+    write("12a\n");
+    auto oStream = Stream<CsvRow, std::vector>::csv(path);
+    auto rows = oStream.collect();
+
+    ASSERT_THROW(rows[0].as<int>(0), std::invalid_argument);
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_JsonLines_Test) {
+    write("{\"type\": \"click\", \"user\": {\"id\": 7, \"tags\": [\"a\", \"b\"]}, \"ms\": 12.5, \"ok\": true}\n"
+          "\n"
+          "{\"type\":\"view\",\"note\":\"a \\\"quoted\\\" \\u00e9, {not: structural}\",\"ms\":3,\"ok\":false}\n");
+    auto oStream = Stream<JsonValue, std::vector>::jsonLines(path);
+
+    auto events = oStream.collect();
+
+    ASSERT_EQ(events.size(), 2UL);
+    ASSERT_EQ(events[0].get("type").asString(), "click");
+    ASSERT_EQ(events[0].get("user").get("id").asInt(), 7);
+    ASSERT_EQ(events[0].get("user").get("tags").raw(), "[\"a\", \"b\"]");
+    ASSERT_EQ(events[0].get("ms").asDouble(), 12.5);
+    ASSERT_TRUE(events[0].get("ok").asBool());
+    ASSERT_FALSE(events[0].get("note"));
+    ASSERT_EQ(events[1].get("note").asString(), "a \"quoted\" \xc3\xa9, {not: structural}");
+    ASSERT_EQ(events[1].get("ms").asInt(), 3);
+    ASSERT_FALSE(events[1].get("ok").asBool());
+    ASSERT_THROW(events[1].get("type").asInt(), std::invalid_argument);
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_JsonLinesFilterMap_Test) {
+    string content;
+    for (int i = 0; i < 1000; i++)
+        content += "{\"payload\":\"" + string(i % 100, 'x') + "\",\"level\":\"" + (i % 3 ? "info" : "error") + "\",\"latency\":" + to_string(i) + "}\n";
+    write(content);
+
+    long result = Stream<JsonValue, std::vector>::jsonLines(path)
+        .filter([](const JsonValue &event) { return event.get("level").asStringView() == "error"; })
+        .map([](const JsonValue &event) { return long(event.get("latency").asInt()); })
+        .sum();
+
+    ASSERT_EQ(result, 166833L);
+}
+
+#endif
+
+#ifdef CPPSTREAMS_HAS_WRITEV
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_WriteLines_Test) {
+    vector<int> numbers = {1, -2, 3};
+
+    size_t ints = Stream<int, std::vector>::makeStream(numbers).writeLines(path);
+    string intsContent = read();
+    size_t doubles = Stream<double, std::vector>::range(0.0, 1.0, 0.25).writeLines(path);
+    string doublesContent = read();
+
+    ASSERT_EQ(ints, 3UL);
+    ASSERT_EQ(intsContent, "1\n-2\n3\n");
+    ASSERT_EQ(doubles, 4UL);
+    ASSERT_EQ(doublesContent, "0\n0.25\n0.5\n0.75\n");
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_WriteToFileDescriptor_Test) {
+    vector<string> words = {"a", "bb", "ccc"};
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    size_t result = Stream<string, std::vector>::makeStream(words)
+        .filter([](const string &word) { return word.size() > 1; })
+        .writeTo(fd, ",");
+    ::close(fd);
+
+    ASSERT_EQ(result, 2UL);
+    ASSERT_EQ(read(), "bb,ccc,");
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_WriteLinesSeveralFlushes_Test) {
+    // About 6MB, written with several writev calls
+    size_t written = Stream<long, std::vector>::range(0, 800000)
+        .map([](const long &iValue) { return iValue * 1000; })
+        .writeLines(path);
+    auto oStream = Stream<string_view, std::vector>::lines(path);
+    long sum = oStream.map([](const string_view &line) { return stol(string(line)); }).sum();
+
+    ASSERT_EQ(written, 800000UL);
+    ASSERT_EQ(sum, 799999L * 800000 / 2 * 1000);
+}
+
+TEST_F(StreamsFromFileTests, StreamsFromFileTests_WriteLinesUnwritablePath_Test) {
+    vector<int> numbers = {1};
+    auto oStream = Stream<int, std::vector>::makeStream(numbers);
+    string unwritable = path + ".missing/out.txt";
+
+    ASSERT_THROW(oStream.writeLines(unwritable), std::system_error);
+}
+
+#endif
@@ -0,0 +1,121 @@
+#include <cppstreams.h>
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+
+using ::testing::Test;
+using namespace std;
+
+
+class StreamsFromGeneratorTests : public Test {
+
+protected:
+
+    StreamsFromGeneratorTests() {}
+
+    virtual ~StreamsFromGeneratorTests() {}
+
+};
+
+TEST_F(StreamsFromGeneratorTests, StreamsFromGeneratorTests_Range_Test) {
+    using IntStream = Stream<int, std::vector>;
+
+    ASSERT_EQ(IntStream::range(0, 5).collect(), vector<int>({0, 1, 2, 3, 4}));
+    ASSERT_EQ(IntStream::range(10, 0, -3).collect(), vector<int>({10, 7, 4, 1}));
+    ASSERT_EQ(IntStream::range(5, 5).count(), 0UL);
+
+    long sum = Stream<long, std::vector>::range(0, 1000000)
+        .filter([](const long &value) { return value % 2 == 0; })
+        .sum();
+    ASSERT_EQ(sum, 249999500000L);
+}
+
+TEST_F(StreamsFromGeneratorTests, StreamsFromGeneratorTests_RangeAtTheEdgesOfTheType_Test) {
+    using IntStream = Stream<int, std::vector>;
+    const int max = numeric_limits<int>::max();
+    const int min = numeric_limits<int>::min();
+
+    ASSERT_EQ(IntStream::range(max - 7, max, 3).collect(), vector<int>({max - 7, max - 4, max - 1}));
+    ASSERT_EQ(IntStream::range(min + 7, min, -3).collect(), vector<int>({min + 7, min + 4, min + 1}));
+    ASSERT_EQ(IntStream::range(max - 1, max).collect(), vector<int>({max - 1}));
+    ASSERT_EQ(IntStream::range(min, max, max).count(), 3UL);
+
+    auto bytes = Stream<unsigned char, std::vector>::range(250, 255, 2).collect();
+    ASSERT_EQ(bytes, vector<unsigned char>({250, 252, 254}));
+}
+
+TEST_F(StreamsFromGeneratorTests, StreamsFromGeneratorTests_IterateWithLimit_Test) {
+    auto powers = Stream<long, std::vector>::iterate(1, [](const long &value) { return value * 2; })
+        .limit(10)
+        .collect();
+
+    ASSERT_EQ(powers.size(), 10UL);
+    ASSERT_EQ(powers.front(), 1);
+    ASSERT_EQ(powers.back(), 512);
+
+    auto belowThousand = Stream<long, std::vector>::iterate(1, [](const long &value) { return value * 3; })
+        .takeWhile([](const long &value) { return value < 1000; })
+        .collect();
+    ASSERT_EQ(belowThousand, vector<long>({1, 3, 9, 27, 81, 243, 729}));
+}
+
+TEST_F(StreamsFromGeneratorTests, StreamsFromGeneratorTests_Generate_Test) {
+    int next = 0;
+    auto squares = Stream<int, std::vector>::generate([&next]() { next++; return next * next; })
+        .filter([](const int &iValue) { return iValue % 2 == 1; })
+        .collect(3);
+
+    ASSERT_EQ(squares, vector<int>({1, 9, 25}));
+    ASSERT_EQ(next, 5);
+}
+
+#ifdef CPPSTREAMS_HAS_COROUTINES
+namespace {
+    struct Node {
+        int value;
+        vector<Node> children;
+    };
+
+    Generator<int> walk(const Node &node) {
+        co_yield node.value;
+        for (const auto &child : node.children) {
+            for (int value : walk(child))
+                co_yield value;
+        }
+    }
+
+    Generator<int> repeat(int value) {
+        for (int i = 0; i < value; i++)
+            co_yield value;
+    }
+}
+
+TEST_F(StreamsFromGeneratorTests, StreamsFromGeneratorTests_FromCoroutine_Test) {
+    Node tree{1, {{2, {{3, {}}, {4, {}}}}, {5, {}}}};
+    auto stream = Stream<int, std::vector>::fromGenerator([&tree]() { return walk(tree); });
+
+    ASSERT_EQ(stream.collect(), vector<int>({1, 2, 3, 4, 5}));
+    ASSERT_EQ(stream.filter([](const int &iValue) { return iValue % 2 == 0; }).sum(), 6);
+}
+
+TEST_F(StreamsFromGeneratorTests, StreamsFromGeneratorTests_ToCoroutine_Test) {
+    vector<int> seen;
+    for (int value : Stream<int, std::vector>::range(0, 100).map([](const int &iValue) { return iValue * iValue; }).toGenerator()) {
+        if (value > 50)
+            break;
+        seen.push_back(value);
+    }
+
+    ASSERT_EQ(seen, vector<int>({0, 1, 4, 9, 16, 25, 36, 49}));
+}
+
+TEST_F(StreamsFromGeneratorTests, StreamsFromGeneratorTests_FlatMapToCoroutine_Test) {
+    vector<int> testVector{1, 0, 3, 2};
+    auto stream = Stream<int, std::vector>::makeStream(testVector)
+        .flatMap([](const int &iValue) { return repeat(iValue); });
+
+    ASSERT_EQ(stream.collect(), vector<int>({1, 3, 3, 3, 2, 2}));
+    ASSERT_EQ(stream.limit(2).collect(), vector<int>({1, 3}));
+}
+
+#endif
@@ -141,3 +141,27 @@ TEST_F(StreamsFromListTests, StreamsFromListTests_SumAfterFilter_Test) {
 
     ASSERT_EQ(result, 20);
 }
+
+TEST_F(StreamsFromListTests, StreamsFromListTests_FlatMapToStream_Test) {
+    list<int> testList{0, 1, 2};
+    list<int> doubles{10, 20};
+    std::list<int> resultList = Stream<int, std::list>::makeStream(testList)
+            .flatMap([&doubles](const int &iValue) {
+                return Stream<int, std::list>::makeStream(doubles)
+                        .map([iValue](const int &d) { return d + iValue; });
+            })
+            .filter([](const int &iValue) { return iValue != 21; })
+            .collect();
+
+    ASSERT_EQ(resultList, list<int>({10, 20, 11, 12, 22}));
+}
+
+TEST_F(StreamsFromListTests, StreamsFromListTests_ForEach_Test) {
+    std::list<int> testList{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::list<int> visited;
+    Stream<int, std::list>::makeStream(testList)
+            .filter([](const int &iValue) { return iValue % 3 == 0; })
+            .forEach([&visited](const int &iValue) { visited.push_back(iValue); });
+
+    ASSERT_EQ(visited, std::list<int>({0, 3, 6, 9}));
+}
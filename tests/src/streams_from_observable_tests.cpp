@@ -0,0 +1,105 @@
+#include <cppstreams.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include <set>
+
+using ::testing::Test;
+using namespace std;
+
+
+class StreamsFromObservableTests : public Test {
+
+protected:
+
+    StreamsFromObservableTests() {}
+
+    virtual ~StreamsFromObservableTests() {}
+
+};
+
+TEST_F(StreamsFromObservableTests, StreamsFromObservableTests_SumFollowsInsertAndErase_Test) {
+    ObservableContainer<int, std::vector> book(vector<int>{0, 1, 2, 3, 4});
+    auto sum = IncrementalStream<int, std::vector>::makeStream(book)
+            .filter([](const int &iValue) { return iValue % 2 == 0; })
+            .sum();
+
+    ASSERT_EQ(sum.get(), 6);
+
+    book.insert(10);
+    book.insert(11);
+    ASSERT_EQ(sum.get(), 16);
+
+    book.erase(2);
+    book.erase(3);
+    ASSERT_EQ(sum.get(), 14);
+}
+
+TEST_F(StreamsFromObservableTests, StreamsFromObservableTests_CountAndReduce_Test) {
+    ObservableContainer<int, std::set> ids(set<int>{1, 2, 3});
+    auto count = IncrementalStream<int, std::set>::makeStream(ids).count();
+    auto product = IncrementalStream<int, std::set>::makeStream(ids)
+            .map([](const int &value) { return value * 2; })
+            .reduce(1, [](int acc, const int &value) { return acc * value; },
+                       [](int acc, const int &value) { return acc / value; });
+
+    ASSERT_EQ(count.get(), 3UL);
+    ASSERT_EQ(product.get(), 48);
+
+    ids.insert(2);
+    ASSERT_EQ(count.get(), 3UL);
+    ids.insert(4);
+    ASSERT_EQ(count.get(), 4UL);
+    ASSERT_EQ(product.get(), 384);
+
+    ids.erase(1);
+    ASSERT_EQ(count.get(), 3UL);
+    ASSERT_EQ(product.get(), 192);
+}
+
+TEST_F(StreamsFromObservableTests, StreamsFromObservableTests_CollectFollowsChanges_Test) {
+    ObservableContainer<int, std::vector> book;
+    std::vector<int> lastSeen;
+    {
+        auto collected = IncrementalStream<int, std::vector>::makeStream(book)
+                .filter([](const int &iValue) { return iValue > 10; })
+                .collect();
+
+        book.insert(5);
+        book.insert(20);
+        book.insert(30);
+        book.erase(20);
+        lastSeen = collected.get();
+    }
+    book.insert(40);
+
+    ASSERT_EQ(lastSeen, vector<int>({30}));
+    ASSERT_EQ(book.get(), vector<int>({5, 30, 40}));
+}
+
+TEST_F(StreamsFromObservableTests, StreamsFromObservableTests_CollectToSetCountsDuplicates_Test) {
+    ObservableContainer<int, std::vector> book;
+    auto collected = IncrementalStream<int, std::set>::makeStream(book).collect();
+
+    book.insert(1);
+    book.insert(1);
+    book.erase(1);
+    ASSERT_EQ(collected.get(), set<int>({1}));
+
+    book.erase(1);
+    ASSERT_EQ(collected.get(), set<int>());
+}
+
+TEST_F(StreamsFromObservableTests, StreamsFromObservableTests_CollectToSetAfterMap_Test) {
+    ObservableContainer<int, std::set> ids;
+    auto collected = IncrementalStream<int, std::set>::makeStream(ids)
+            .map([](const int &value) { return abs(value); })
+            .collect();
+
+    ids.insert(1);
+    ids.insert(-1);
+    ids.erase(-1);
+    ASSERT_EQ(collected.get(), set<int>({1}));
+
+    ids.erase(1);
+    ASSERT_EQ(collected.get(), set<int>());
+}
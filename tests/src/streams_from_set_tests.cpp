@@ -132,3 +132,48 @@ TEST_F(StreamsFromSetTests, StreamsFromSetTests_ResultSetIsOrdered_Test) {
     ASSERT_EQ(*it++, 99);
     ASSERT_EQ(*it, 100);
 }
+
+TEST_F(StreamsFromSetTests, StreamsFromSetTests_DistinctAfterFilterAndMap_Test) {
+    set<int> testSet{0, 1, 2, 3, 4, 5};
+    std::set<int> resultSet = Stream<int, std::set>::makeStream(testSet)
+        .filter([](const int &iValue) { return iValue > 0; })
+        .distinct()
+        .map([](const int &iValue) { return iValue / 2; })
+        .distinct()
+        .collect();
+
+    ASSERT_EQ(resultSet, set<int>({0, 1, 2}));
+}
+
+TEST_F(StreamsFromSetTests, StreamsFromSetTests_MinMax_Test) {
+    set<int> testSet{7, 3, 11, 5};
+    auto stream = Stream<int, std::set>::makeStream(testSet);
+
+    ASSERT_EQ(stream.min().value(), 3);
+    ASSERT_EQ(stream.max().value(), 11);
+
+    auto filteredMax = stream.filter([](const int &iValue) { return iValue != 11; }).max();
+    ASSERT_EQ(filteredMax.value(), 7);
+    ASSERT_EQ(stream.minMax().value(), make_pair(3, 11));
+}
+
+TEST_F(StreamsFromSetTests, StreamsFromSetTests_PartitioningBy_Test) {
+    set<int> testSet{0, 1, 2, 3, 4};
+    auto parts = Stream<int, std::set>::makeStream(testSet)
+        .partitioningBy([](const int &iValue) { return iValue < 2; });
+
+    ASSERT_EQ(parts.first, set<int>({0, 1}));
+    ASSERT_EQ(parts.second, set<int>({2, 3, 4}));
+}
+
+TEST_F(StreamsFromSetTests, StreamsFromSetTests_MergeJoin_Test) {
+    set<int> left{1, 3, 4, 7, 9, 12};
+    set<int> right{0, 3, 5, 7, 8, 12, 15};
+    auto identity = [](const int &iValue) { return iValue; };
+    std::set<int> resultSet = Stream<int, std::set>::makeStream(left)
+        .mergeJoin(Stream<int, std::set>::makeStream(right), identity, identity,
+                   [](const int &l, const int &r) { return l + r; })
+        .collect();
+
+    ASSERT_EQ(resultSet, set<int>({6, 14, 24}));
+}
@@ -5,6 +5,10 @@
 #include <gtest/gtest.h>
 #include <vector>
 #include <string>
+#include <thread>
+#include <stdexcept>
+#include <atomic>
+#include <chrono>
 
 using ::testing::Test;
 using namespace std;
@@ -140,3 +144,550 @@ TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_SumAfterFilter_Test) {
 
     ASSERT_EQ(result, 20);
 }
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_FlatMapSplitsLines_Test) {
+    vector<string> lines{"a bb", "", "ccc d e"};
+    std::vector<string> words = Stream<string, std::vector>::makeStream(lines)
+        .flatMap([](const string &line) {
+            vector<string> tokens;
+            size_t start = 0;
+            while (start < line.size()) {
+                size_t end = line.find(' ', start);
+                if (end == string::npos)
+                    end = line.size();
+                tokens.push_back(line.substr(start, end - start));
+                start = end + 1;
+            }
+            return tokens;
+        })
+        .collect();
+
+    ASSERT_EQ(words, vector<string>({"a", "bb", "ccc", "d", "e"}));
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_FlatMapIsLazy_Test) {
+    vector<int> testVector{1, 2, 3, 4};
+    int calls = 0;
+    auto result = Stream<int, std::vector>::makeStream(testVector)
+        .flatMap([&calls](const int &value) { calls++; return vector<int>(value, value); })
+        .findFirst([](const int &value) { return value == 2; });
+
+    ASSERT_EQ(result.value_or(0), 2);
+    ASSERT_EQ(calls, 2);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_DistinctKeepsFirstOccurrences_Test) {
+    vector<int> testVector{3, 1, 3, 2, 1, 4, 2, 3};
+    std::vector<int> resultVector = Stream<int, std::vector>::makeStream(testVector)
+        .distinct()
+        .collect();
+
+    ASSERT_EQ(resultVector, vector<int>({3, 1, 2, 4}));
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_DistinctOnManyStrings_Test) {
+    vector<string> testVector;
+    for (int i = 0; i < 1000; i++)
+        testVector.push_back(to_string(i % 300));
+    size_t count = Stream<string, std::vector>::makeStream(testVector)
+        .distinct()
+        .count();
+
+    ASSERT_EQ(count, 300UL);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_SortedWorks_Test) {
+    vector<int> testVector{5, 3, 9, 1, 7};
+    std::vector<int> resultVector = Stream<int, std::vector>::makeStream(testVector)
+        .sorted()
+        .collect();
+
+    ASSERT_EQ(resultVector, vector<int>({1, 3, 5, 7, 9}));
+
+    resultVector = Stream<int, std::vector>::makeStream(testVector)
+        .sorted(std::greater<int>())
+        .collect();
+
+    ASSERT_EQ(resultVector, vector<int>({9, 7, 5, 3, 1}));
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_SortedCollectLimitKeepsSmallest_Test) {
+    vector<int> testVector;
+    for (int i = 0; i < 1000; i++)
+        testVector.push_back((i * 7919) % 1000);
+    std::vector<int> resultVector = Stream<int, std::vector>::makeStream(testVector)
+        .sorted(std::greater<int>())
+        .collect(5);
+
+    ASSERT_EQ(resultVector, vector<int>({999, 998, 997, 996, 995}));
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_SortedByKeyThenDistinct_Test) {
+    vector<int> testVector{-1, 1, -1, 2};
+    std::vector<int> resultVector = Stream<int, std::vector>::makeStream(testVector)
+        .sorted([](const int &a, const int &b) { return std::abs(a) < std::abs(b); })
+        .distinct()
+        .collect();
+    std::sort(resultVector.begin(), resultVector.end());
+
+    ASSERT_EQ(resultVector, vector<int>({-1, 1, 2}));
+
+    resultVector = Stream<int, std::vector>::makeStream(testVector)
+        .sorted(std::greater<int>())
+        .distinct()
+        .collect();
+
+    ASSERT_EQ(resultVector, vector<int>({2, 1, -1}));
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_MinMax_Test) {
+    vector<int> testVector{4, -2, 9, 0, 9, -2};
+    auto stream = Stream<int, std::vector>::makeStream(testVector);
+
+    ASSERT_EQ(stream.min().value(), -2);
+    ASSERT_EQ(stream.max().value(), 9);
+    ASSERT_EQ(stream.minMax().value(), make_pair(-2, 9));
+
+    auto evenBounds = stream.filter([](const int &iValue) { return iValue % 2 == 0; }).minMax();
+    ASSERT_EQ(evenBounds.value(), make_pair(-2, 4));
+
+    auto reversedMax = stream.map([](const int &iValue) { return iValue * 10; }).max(std::greater<int>());
+    ASSERT_EQ(reversedMax.value(), -20);
+
+    vector<int> emptyVector;
+    auto emptyMin = Stream<int, std::vector>::makeStream(emptyVector).min();
+    ASSERT_FALSE(emptyMin);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_MinByMaxBy_Test) {
+    vector<string> testVector{"ccc", "a", "bb", "dd", "e"};
+    auto stream = Stream<string, std::vector>::makeStream(testVector);
+
+    auto length = [](const string &s) { return s.size(); };
+
+    ASSERT_EQ(stream.minBy(length).value(), "a");
+    ASSERT_EQ(stream.maxBy(length).value(), "ccc");
+    ASSERT_EQ(stream.min().value(), "a");
+    ASSERT_EQ(stream.max().value(), "e");
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_GroupingByCounting_Test) {
+    vector<string> testVector{"apple", "avocado", "banana", "cherry", "blueberry", "apricot"};
+    auto counts = Stream<string, std::vector>::makeStream(testVector)
+        .groupingBy([](const string &s) { return s[0]; }, Collectors::counting());
+
+    ASSERT_EQ(counts.size(), 3UL);
+    ASSERT_EQ(*counts.find('a'), 3UL);
+    ASSERT_EQ(*counts.find('b'), 2UL);
+    ASSERT_EQ(*counts.find('c'), 1UL);
+    ASSERT_EQ(counts.find('d'), nullptr);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_GroupingByDownstreams_Test) {
+    vector<int> testVector{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    auto stream = Stream<int, std::vector>::makeStream(testVector);
+    auto parity = [](const int &iValue) { return iValue % 2; };
+    auto identity = [](const int &iValue) { return iValue; };
+
+    auto sums = stream.groupingBy(parity, Collectors::summing(identity));
+    ASSERT_EQ(*sums.find(0), 20);
+    ASSERT_EQ(*sums.find(1), 25);
+
+    auto averages = stream.groupingBy(parity, Collectors::averaging(identity));
+    ASSERT_DOUBLE_EQ(*averages.find(0), 4.0);
+    ASSERT_DOUBLE_EQ(*averages.find(1), 5.0);
+
+    auto groups = stream.groupingBy(parity);
+    ASSERT_EQ(*groups.find(1), vector<int>({1, 3, 5, 7, 9}));
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_PartitioningBy_Test) {
+    vector<int> testVector{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    auto isEven = [](const int &iValue) { return iValue % 2 == 0; };
+    auto parts = Stream<int, std::vector>::makeStream(testVector)
+        .partitioningBy(isEven);
+
+    ASSERT_EQ(parts.first, vector<int>({0, 2, 4, 6, 8}));
+    ASSERT_EQ(parts.second, vector<int>({1, 3, 5, 7, 9}));
+
+    auto counts = Stream<int, std::vector>::makeStream(testVector)
+        .filter([](const int &iValue) { return iValue > 2; })
+        .partitioningBy(isEven, Collectors::counting());
+
+    ASSERT_EQ(counts, make_pair(size_t(3), size_t(4)));
+
+    vector<int> small{1, 2, 3};
+    auto averages = Stream<int, std::vector>::makeStream(small)
+        .partitioningBy([](const int &iValue) { return iValue > 10; },
+                        Collectors::averaging([](const int &iValue) { return iValue; }));
+
+    ASSERT_EQ(averages, make_pair(0.0, 2.0));
+}
+
+namespace {
+    struct Event {
+        int userId;
+        string action;
+    };
+
+    struct User {
+        int id;
+        string name;
+    };
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_JoinEnrichesEvents_Test) {
+    vector<Event> events{{1, "login"}, {2, "click"}, {3, "logout"}, {1, "click"}};
+    vector<User> users{{1, "ann"}, {2, "bob"}};
+    auto eventUser = [](const Event &e) { return e.userId; };
+    auto userId = [](const User &u) { return u.id; };
+
+    auto joined = Stream<Event, std::vector>::makeStream(events)
+        .join(Stream<User, std::vector>::makeStream(users), eventUser, userId,
+              [](const Event &e, const User &u) { return u.name + ":" + e.action; })
+        .sorted()
+        .collect();
+    ASSERT_EQ(joined, vector<string>({"ann:click", "ann:login", "bob:click"}));
+
+    auto reversed = Stream<User, std::vector>::makeStream(users)
+        .join(Stream<Event, std::vector>::makeStream(events), userId, eventUser,
+              [](const User &u, const Event &e) { return u.name + ":" + e.action; })
+        .sorted()
+        .collect();
+    ASSERT_EQ(reversed, joined);
+
+    auto outer = Stream<Event, std::vector>::makeStream(events)
+        .leftOuterJoin(Stream<User, std::vector>::makeStream(users), eventUser, userId,
+                       [](const Event &e, const User *u) { return (u ? u->name : "?") + ":" + e.action; })
+        .collect();
+    ASSERT_EQ(outer, vector<string>({"ann:login", "bob:click", "?:logout", "ann:click"}));
+
+    auto semi = Stream<Event, std::vector>::makeStream(events)
+        .semiJoin(Stream<User, std::vector>::makeStream(users), eventUser, userId)
+        .count();
+    ASSERT_EQ(semi, 3UL);
+
+    auto anti = Stream<Event, std::vector>::makeStream(events)
+        .antiJoin(Stream<User, std::vector>::makeStream(users), eventUser, userId)
+        .collect();
+    ASSERT_EQ(anti.size(), 1UL);
+    ASSERT_EQ(anti[0].action, "logout");
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_JoinPartitionsLargeBuildSide_Test) {
+    vector<long> left;
+    vector<long> right;
+    for (long i = 0; i < 100000; i++) {
+        right.push_back(i);
+        if (i % 3 == 0)
+            left.push_back(i);
+    }
+    auto identity = [](const long &value) { return value; };
+
+    auto sum = Stream<long, std::vector>::makeStream(right)
+        .join(Stream<long, std::vector>::makeStream(left).map(identity), identity, identity,
+              [](const long &r, const long &l) { return r + l; })
+        .sum();
+
+    ASSERT_EQ(sum, 2 * (99999L / 3) * (99999L / 3 + 1) / 2 * 3);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_JoinStreamsUnboundedProbeOverLargeBuildSide_Test) {
+    vector<long> table;
+    for (long i = 0; i < 100000; i++)
+        table.push_back(i);
+    auto identity = [](const long &value) { return value; };
+    long pulled = 0;
+
+    auto result = Stream<long, std::vector>::generate([&pulled]() { return pulled++ * 7; })
+        .join(Stream<long, std::vector>::makeStream(table), identity, identity,
+              [](const long &probe, const long &) { return probe; })
+        .limit(3)
+        .collect();
+
+    ASSERT_EQ(result, vector<long>({0, 7, 14}));
+    ASSERT_EQ(pulled, 3);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_MergeJoinWithDuplicateKeys_Test) {
+    vector<pair<int, char>> left{{1, 'a'}, {2, 'b'}, {2, 'c'}, {4, 'd'}};
+    vector<pair<int, char>> right{{2, 'x'}, {2, 'y'}, {3, 'z'}, {4, 'w'}};
+    auto key = [](const pair<int, char> &p) { return p.first; };
+    auto result = Stream<pair<int, char>, std::vector>::makeStream(left)
+        .mergeJoin(Stream<pair<int, char>, std::vector>::makeStream(right), key, key,
+                   [](const pair<int, char> &l, const pair<int, char> &r) { return string{l.second, r.second}; })
+        .collect();
+
+    ASSERT_EQ(result, vector<string>({"bx", "by", "cx", "cy", "dw"}));
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_ZipStopsAtShortest_Test) {
+    vector<string> names{"x", "y", "z"};
+    vector<double> values{1.5, 2.5};
+    auto zipped = Stream<string, std::vector>::makeStream(names)
+        .zip(Stream<double, std::vector>::makeStream(values))
+        .collect();
+
+    ASSERT_EQ(zipped, (vector<pair<string, double>>{{"x", 1.5}, {"y", 2.5}}));
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_ZipWithIndexAndEnumerate_Test) {
+    vector<char> testVector{'a', 'b', 'c', 'd'};
+    auto stream = Stream<char, std::vector>::makeStream(testVector)
+        .filter([](const char &c) { return c != 'b'; });
+
+    auto indexed = stream.zipWithIndex().collect();
+    ASSERT_EQ(indexed, (vector<pair<char, size_t>>{{'a', 0}, {'c', 1}, {'d', 2}}));
+
+    auto enumerated = stream.enumerate().collect();
+    ASSERT_EQ(enumerated, (vector<pair<size_t, char>>{{0, 'a'}, {1, 'c'}, {2, 'd'}}));
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_SlidingWindows_Test) {
+    vector<int> testVector{3, 1, 4, 1, 5, 9, 2, 6};
+    auto stream = Stream<int, std::vector>::makeStream(testVector);
+
+    ASSERT_EQ(stream.windowSum(3, 1).collect(), vector<int>({8, 6, 10, 15, 16, 17}));
+    ASSERT_EQ(stream.windowMin(3, 1).collect(), vector<int>({1, 1, 1, 1, 2, 2}));
+    ASSERT_EQ(stream.windowMax(3, 2).collect(), vector<int>({4, 5, 9}));
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_TumblingAndCustomWindows_Test) {
+    vector<int> testVector{1, 2, 3, 4, 5, 6, 7};
+    auto stream = Stream<int, std::vector>::makeStream(testVector);
+
+    ASSERT_EQ(stream.windowSum(2, 2).collect(), vector<int>({3, 7, 11}));
+    ASSERT_EQ(stream.windowSum(2, 3).collect(), vector<int>({3, 9}));
+
+    auto concat = [](const string &a, const string &b) { return a + b; };
+    auto words = stream.map([](const int &iValue) { return to_string(iValue); })
+        .window(3, 1, string(), concat)
+        .collect();
+    ASSERT_EQ(words, vector<string>({"123", "234", "345", "456", "567"}));
+
+    vector<double> doubles{0.5, 1.5, 2.5};
+    auto doubleSums = Stream<double, std::vector>::makeStream(doubles).windowSum(2, 1).collect();
+    ASSERT_EQ(doubleSums, vector<double>({2.0, 4.0}));
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_SkipAndLimit_Test) {
+    vector<int> testVector{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    auto stream = Stream<int, std::vector>::makeStream(testVector);
+
+    ASSERT_EQ(stream.skip(7).collect(), vector<int>({7, 8, 9}));
+    ASSERT_EQ(stream.skip(20).count(), 0UL);
+    ASSERT_EQ(stream.skip(2).limit(3).collect(), vector<int>({2, 3, 4}));
+
+    auto odd = stream.filter([](const int &iValue) { return iValue % 2 == 1; });
+    ASSERT_EQ(odd.skip(1).limit(2).collect(), vector<int>({3, 5}));
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_LimitBoundsUpstreamWork_Test) {
+    vector<int> testVector{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int calls = 0;
+    auto result = Stream<int, std::vector>::makeStream(testVector)
+        .map([&calls](const int &iValue) { calls++; return iValue * 2; })
+        .limit(3)
+        .collect();
+
+    ASSERT_EQ(result, vector<int>({0, 2, 4}));
+    ASSERT_EQ(calls, 3);
+
+    auto topThree = Stream<int, std::vector>::makeStream(testVector)
+        .sorted(std::greater<int>())
+        .limit(3)
+        .sum();
+    ASSERT_EQ(topThree, 24);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_TakeWhileDropWhile_Test) {
+    vector<int> testVector{1, 2, 3, 10, 4, 20};
+    auto stream = Stream<int, std::vector>::makeStream(testVector);
+    auto small = [](const int &iValue) { return iValue < 5; };
+
+    ASSERT_EQ(stream.takeWhile(small).collect(), vector<int>({1, 2, 3}));
+    ASSERT_EQ(stream.dropWhile(small).collect(), vector<int>({10, 4, 20}));
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_SummaryStatistics_Test) {
+    vector<double> testVector;
+    for (int i = 0; i < 5000; i++)
+        testVector.push_back(1e9 + (i % 10));
+    auto stream = Stream<double, std::vector>::makeStream(testVector);
+
+    auto stats = stream.summaryStatistics();
+    ASSERT_EQ(stats.count, 5000UL);
+    ASSERT_DOUBLE_EQ(stats.mean, 1e9 + 4.5);
+    ASSERT_DOUBLE_EQ(stats.min, 1e9);
+    ASSERT_DOUBLE_EQ(stats.max, 1e9 + 9);
+    ASSERT_NEAR(stats.variance(), 8.25, 1e-6);
+
+    auto filtered = stream.filter([](const double &value) { return value != 1e9; }).summaryStatistics();
+    ASSERT_EQ(filtered.count, 4500UL);
+    ASSERT_DOUBLE_EQ(filtered.mean, 1e9 + 5);
+    ASSERT_NEAR(filtered.variance(), 20.0 / 3, 1e-6);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_SummaryStatisticsMerge_Test) {
+    vector<int> first{1, 2, 3};
+    vector<int> second{4, 5, 6, 7};
+
+    auto stats = Stream<int, std::vector>::makeStream(first).summaryStatistics();
+    stats.merge(Stream<int, std::vector>::makeStream(second).summaryStatistics());
+    SummaryStatistics<int> sequential;
+    for (int i = 1; i <= 7; i++)
+        sequential.accept(i);
+
+    ASSERT_EQ(stats.count, 7UL);
+    ASSERT_EQ(stats.sum, 28);
+    ASSERT_EQ(stats.min, 1);
+    ASSERT_EQ(stats.max, 7);
+    ASSERT_DOUBLE_EQ(stats.mean, 4.0);
+    ASSERT_DOUBLE_EQ(stats.variance(), 4.0);
+    ASSERT_DOUBLE_EQ(sequential.variance(), 4.0);
+    ASSERT_DOUBLE_EQ(sequential.sampleVariance(), 28.0 / 6);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_ApproxCountDistinct_Test) {
+    vector<long> testVector;
+    for (long i = 0; i < 200000; i++)
+        testVector.push_back(i % 50000);
+    auto stream = Stream<long, std::vector>::makeStream(testVector);
+
+    size_t estimate = stream.approxCountDistinct();
+    ASSERT_NEAR(estimate, 50000.0, 50000 * 0.03);
+
+    size_t small = stream.limit(100).approxCountDistinct();
+    ASSERT_NEAR(small, 100.0, 3.0);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_HyperLogLogMerge_Test) {
+    HyperLogLog first;
+    HyperLogLog second;
+    for (uint64_t i = 0; i < 30000; i++) {
+        first.add(FastHash()(i));
+        second.add(FastHash()(i + 20000));
+    }
+    first.merge(second);
+
+    ASSERT_NEAR(first.estimate(), 50000.0, 50000 * 0.03);
+    ASSERT_THROW(first.merge(HyperLogLog(10)), std::invalid_argument);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_ApproxQuantiles_Test) {
+    vector<int> testVector;
+    for (int i = 0; i < 100000; i++)
+        testVector.push_back((i * 7919) % 100000);
+
+    auto quantiles = Stream<int, std::vector>::makeStream(testVector)
+        .approxQuantiles({0.0, 0.5, 0.99, 1.0});
+
+    ASSERT_EQ(quantiles.size(), 4UL);
+    ASSERT_NEAR(quantiles[0], 0.0, 2000);
+    ASSERT_NEAR(quantiles[1], 50000.0, 2000);
+    ASSERT_NEAR(quantiles[2], 99000.0, 2000);
+    ASSERT_NEAR(quantiles[3], 99999.0, 2000);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_QuantileSketchMerge_Test) {
+    QuantileSketch low;
+    QuantileSketch high;
+    for (int i = 0; i < 50000; i++) {
+        low.add(i);
+        high.add(50000 + i);
+    }
+    low.merge(high);
+
+    ASSERT_EQ(low.size(), 100000UL);
+    ASSERT_NEAR(low.quantiles({0.25})[0], 25000.0, 2000);
+    ASSERT_NEAR(low.quantiles({0.75})[0], 75000.0, 2000);
+    ASSERT_TRUE(std::isnan(QuantileSketch().quantiles({0.5})[0]));
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_SampleReservoir_Test) {
+    vector<int> testVector;
+    for (int i = 0; i < 10000; i++)
+        testVector.push_back(i);
+    auto stream = Stream<int, std::vector>::makeStream(testVector);
+
+    auto sample = stream.sample(100, 42).collect();
+    ASSERT_EQ(sample.size(), 100UL);
+    ASSERT_EQ(set<int>(sample.begin(), sample.end()).size(), 100UL);
+    ASSERT_EQ(sample, stream.sample(100, 42).collect());
+
+    auto filtered = stream.filter([](const int &iValue) { return iValue % 2 == 0; })
+        .sample(50, 7)
+        .collect();
+    ASSERT_EQ(filtered.size(), 50UL);
+    for (int value : filtered)
+        ASSERT_EQ(value % 2, 0);
+
+    ASSERT_EQ(stream.limit(10).sample(20).count(), 10UL);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_SampleFraction_Test) {
+    vector<int> testVector;
+    for (int i = 0; i < 100000; i++)
+        testVector.push_back(i);
+    auto stream = Stream<int, std::vector>::makeStream(testVector);
+
+    auto sample = stream.sampleFraction(0.01, 3).collect();
+    ASSERT_NEAR(sample.size(), 1000.0, 150.0);
+    ASSERT_TRUE(std::is_sorted(sample.begin(), sample.end()));
+
+    size_t mapped = stream.map([](const int &iValue) { return iValue; }).sampleFraction(0.1, 3).count();
+    ASSERT_NEAR(mapped, 10000.0, 500.0);
+
+    ASSERT_EQ(stream.sampleFraction(1.0).count(), testVector.size());
+    ASSERT_EQ(stream.sampleFraction(0.0).count(), 0UL);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_AsyncKeepsOrder_Test) {
+    vector<int> testVector;
+    for (int i = 0; i < 100000; i++)
+        testVector.push_back(i);
+    std::thread::id caller = std::this_thread::get_id();
+    bool mappedOnCaller = false;
+
+    auto result = Stream<int, std::vector>::makeStream(testVector)
+        .map([&](const int &iValue) { mappedOnCaller |= std::this_thread::get_id() == caller; return iValue * 2; })
+        .async(64)
+        .filter([](const int &iValue) { return iValue % 3 == 0; })
+        .collect();
+
+    ASSERT_FALSE(mappedOnCaller);
+    ASSERT_EQ(result.size(), 33334UL);
+    ASSERT_EQ(result[1], 6);
+    ASSERT_EQ(result.back(), 199998);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_AsyncStopsEarlyAndRethrows_Test) {
+    auto first = Stream<long, std::vector>::iterate(0, [](const long &value) { return value + 1; })
+        .async(16)
+        .limit(5)
+        .collect();
+    ASSERT_EQ(first, vector<long>({0, 1, 2, 3, 4}));
+
+    auto failing = Stream<int, std::vector>::range(0, 10)
+        .map([](const int &iValue) { if (iValue == 7) throw std::runtime_error("bad"); return iValue; })
+        .async();
+    ASSERT_THROW(failing.collect(), std::runtime_error);
+}
+
+TEST_F(StreamsFromVectorTests, StreamsFromVectorTests_AsyncStopsUpstreamEarly_Test) {
+    std::atomic<int> calls{0};
+    auto first = Stream<int, std::vector>::generate([&calls] {
+            std::this_thread::sleep_for(std::chrono::microseconds(10));
+            return calls++;
+        })
+        .async(1024)
+        .limit(3)
+        .collect();
+    int callsAfterStop = calls.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    ASSERT_EQ(first, vector<int>({0, 1, 2}));
+    // Not waiting for the queue to fill up before stopping
+    ASSERT_LT(callsAfterStop, 1024);
+    ASSERT_EQ(calls.load(), callsAfterStop);
+}